@@ -0,0 +1,223 @@
+// Scenario benchmark suite: runs each reproducible scene from scenes.h for N
+// ticks of simulate() (plus drawGrid() every K ticks) and reports throughput
+// as CSV or JSON for nightly regression tracking.
+//
+//   fsand-bench [--scene NAME|all] [--ticks N] [--render-every K] [--seed S]
+//               [--rng sequential|counter] [--threads T] [--heat MODE]
+//               [--temp-scale 1|2|4] [--format csv|json]
+//
+// --temp-scale runs the scenes with a finer temperature field (tempscale.h);
+// those runs cannot render, so they need --render-every 0.
+//
+// Columns / keys per scene:
+//   ticks_per_sec   ticks per second of wall time, rendering included
+//   sim_ms          time inside simulate()
+//   render_ms       time inside drawGrid() + LCD_Refresh()
+//   ns_per_cell     simulate() time per occupied (non-air, non-wall) cell per
+//                   tick, counted from the occupancy bitset before each tick
+//   temp_share      fraction of simulate() time spent in the temperature pass
+//   awake_chunks    mean sleep/wake chunks scanned per tick
+//   tick_p50_us, tick_p95_us, tick_p99_us, tick_worst_us
+//                   simulate() time percentiles from the frame-time
+//                   histogram (frametime.h; bucketed to within 12.5%)
+//   render_p50_us .. render_worst_us
+//                   the same for drawGrid() + LCD_Refresh() (0 without
+//                   rendering)
+//   temp_scale      cells per temperature tile edge
+
+#include "config.h"
+#include "frametime.h"
+#include "grid.h"
+#include "physics.h"
+#include "random.h"
+#include "renderer.h"
+#include "scenes.h"
+#include "settings.h"
+#include "simulation.h"
+#include "parallel.h"
+#include "tempscale.h"
+#include "shim.h"
+#include <sdk/os/lcd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct BenchResult {
+  const Scene *scene;
+  int particlesStart;
+  int particlesEnd;
+  uint64_t simNanos;
+  uint64_t renderNanos;
+  uint64_t tempNanos;
+  uint64_t cellTicks;  // occupied cells summed over ticks
+  uint64_t awakeSum;
+  FrameTimeStats tick;
+  FrameTimeStats render;
+};
+
+static BenchResult runScene(const Scene &scene, uint32_t seed, int ticks, int renderEvery) {
+  BenchResult r = {};
+  r.scene = &scene;
+  sceneLoad(scene, seed);
+  tempScaleLoad();
+  r.particlesStart = tempScaleOccupied();
+
+  uint16_t *vram = static_cast<uint16_t *>(LCD_GetVRAMAddress());
+  hostTempPassNanos = 0;
+  frameTimeReset();
+  for (int tick = 0; tick < ticks; tick++) {
+    r.cellTicks += static_cast<uint64_t>(tempScaleOccupied());
+    const uint64_t t0 = hostNanos();
+    tempScaleSimulate();
+    const uint64_t t1 = hostNanos();
+    r.simNanos += t1 - t0;
+    frameTimeRecord(FrameClock::TICK, static_cast<uint32_t>((t1 - t0) / 1000u));
+    r.awakeSum += static_cast<uint64_t>(tempScaleAwakeChunks());
+    if (renderEvery > 0 && tick % renderEvery == 0) {
+      drawGrid(vram);
+      LCD_Refresh();
+      const uint64_t t2 = hostNanos();
+      r.renderNanos += t2 - t1;
+      frameTimeRecord(FrameClock::RENDER, static_cast<uint32_t>((t2 - t1) / 1000u));
+    }
+  }
+  r.tempNanos = hostTempPassNanos;
+  r.tick   = frameTimeStats(FrameClock::TICK);
+  r.render = frameTimeStats(FrameClock::RENDER);
+  r.particlesEnd = tempScaleOccupied();
+  return r;
+}
+
+static double ratio(double num, double den) {
+  return den > 0.0 ? num / den : 0.0;
+}
+
+static void printCsvHeader() {
+  printf("scene,seed,ticks,render_every,threads,rng,particles_start,particles_end,"
+         "sim_ms,render_ms,ticks_per_sec,ns_per_cell,temp_share,awake_chunks,"
+         "tick_p50_us,tick_p95_us,tick_p99_us,tick_worst_us,"
+         "render_p50_us,render_p95_us,render_p99_us,render_worst_us,temp_scale\n");
+}
+
+static void printCsv(const BenchResult &r, uint32_t seed, int ticks, int renderEvery) {
+  const double simNs = static_cast<double>(r.simNanos);
+  const double totalNs = simNs + static_cast<double>(r.renderNanos);
+  printf("%s,%u,%d,%d,%d,%s,%d,%d,%.3f,%.3f,%.1f,%.2f,%.4f,%.2f,%u,%u,%u,%u,%u,%u,%u,%u,%d\n",
+         r.scene->name, seed, ticks, renderEvery, hostParallelThreads(),
+         randomMode == RandomMode::COUNTER ? "counter" : "sequential",
+         r.particlesStart, r.particlesEnd, simNs / 1e6,
+         static_cast<double>(r.renderNanos) / 1e6,
+         ratio(ticks * 1e9, totalNs),
+         ratio(simNs, static_cast<double>(r.cellTicks)),
+         ratio(static_cast<double>(r.tempNanos), simNs),
+         ratio(static_cast<double>(r.awakeSum), ticks),
+         r.tick.p50Us, r.tick.p95Us, r.tick.p99Us, r.tick.worstUs,
+         r.render.p50Us, r.render.p95Us, r.render.p99Us, r.render.worstUs,
+         tempScaleSelected());
+}
+
+static void printJson(const BenchResult &r, uint32_t seed, int ticks, int renderEvery, bool last) {
+  const double simNs = static_cast<double>(r.simNanos);
+  const double totalNs = simNs + static_cast<double>(r.renderNanos);
+  printf("    {\"scene\": \"%s\", \"description\": \"%s\", \"seed\": %u, \"ticks\": %d, "
+         "\"render_every\": %d, \"threads\": %d, \"rng\": \"%s\",\n"
+         "     \"particles_start\": %d, \"particles_end\": %d, \"sim_ms\": %.3f, "
+         "\"render_ms\": %.3f, \"ticks_per_sec\": %.1f,\n"
+         "     \"ns_per_cell\": %.2f, \"temp_share\": %.4f, \"awake_chunks\": %.2f,\n"
+         "     \"tick_p50_us\": %u, \"tick_p95_us\": %u, \"tick_p99_us\": %u, "
+         "\"tick_worst_us\": %u,\n"
+         "     \"render_p50_us\": %u, \"render_p95_us\": %u, \"render_p99_us\": %u, "
+         "\"render_worst_us\": %u, \"temp_scale\": %d}%s\n",
+         r.scene->name, r.scene->description, seed, ticks, renderEvery,
+         hostParallelThreads(),
+         randomMode == RandomMode::COUNTER ? "counter" : "sequential",
+         r.particlesStart, r.particlesEnd, simNs / 1e6,
+         static_cast<double>(r.renderNanos) / 1e6,
+         ratio(ticks * 1e9, totalNs),
+         ratio(simNs, static_cast<double>(r.cellTicks)),
+         ratio(static_cast<double>(r.tempNanos), simNs),
+         ratio(static_cast<double>(r.awakeSum), ticks),
+         r.tick.p50Us, r.tick.p95Us, r.tick.p99Us, r.tick.worstUs,
+         r.render.p50Us, r.render.p95Us, r.render.p99Us, r.render.worstUs,
+         tempScaleSelected(), last ? "" : ",");
+}
+
+int main(int argc, char **argv) {
+  const char *sceneName = "all";
+  int ticks = 1000;
+  int renderEvery = 0;
+  uint32_t seed = 1;
+  RandomMode rngMode = RandomMode::SEQUENTIAL;
+  int threads = 1;
+  int heat = HEAT_MODE_DEFAULT;
+  int tempScale = TEMP_SCALE;
+  bool json = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+      sceneName = argv[++i];
+    } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+      ticks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--render-every") == 0 && i + 1 < argc) {
+      renderEvery = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    } else if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "sequential") == 0 || strcmp(argv[i + 1], "counter") == 0)) {
+      rngMode = strcmp(argv[++i], "counter") == 0 ? RandomMode::COUNTER : RandomMode::SEQUENTIAL;
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--heat") == 0 && i + 1 < argc &&
+               atoi(argv[i + 1]) >= 0 && atoi(argv[i + 1]) <= HEAT_MODE_MAX) {
+      heat = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--temp-scale") == 0 && i + 1 < argc &&
+               tempScaleSupported(atoi(argv[i + 1]))) {
+      tempScale = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "csv") == 0 || strcmp(argv[i + 1], "json") == 0)) {
+      json = strcmp(argv[++i], "json") == 0;
+    } else {
+      fprintf(stderr, "usage: %s [--scene NAME|all] [--ticks N] [--render-every K] "
+                      "[--seed S] [--rng sequential|counter] [--threads T] "
+                      "[--heat MODE] [--temp-scale 1|2|4] [--format csv|json]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (tempScale != TEMP_SCALE && renderEvery > 0) {
+    fprintf(stderr, "%s: --temp-scale %d needs --render-every 0\n", argv[0], tempScale);
+    return 2;
+  }
+
+  const Scene *only = nullptr;
+  if (strcmp(sceneName, "all") != 0) {
+    only = findScene(sceneName);
+    if (!only) {
+      fprintf(stderr, "unknown scene '%s'; available:", sceneName);
+      for (int i = 0; i < SCENE_COUNT; i++) fprintf(stderr, " %s", SCENES[i].name);
+      fprintf(stderr, "\n");
+      return 2;
+    }
+  }
+
+  randomSetMode(rngMode, seed);
+  hostParallelSetThreads(threads);
+  initGrid();
+  initSettings();
+  setHeatSchedule(heatModePasses[heat], heatModeLevels[heat]);
+  tempScaleSelect(tempScale);
+  unsigned int width, height;
+  LCD_GetSize(&width, &height);
+  initRenderer(width, height);
+
+  if (json) printf("{\n  \"benchmarks\": [\n");
+  else      printCsvHeader();
+  for (int i = 0; i < SCENE_COUNT; i++) {
+    const Scene &scene = SCENES[i];
+    if (only && only != &scene) continue;
+    const BenchResult r = runScene(scene, seed, ticks, renderEvery);
+    const bool last = only || i == SCENE_COUNT - 1;
+    if (json) printJson(r, seed, ticks, renderEvery, last);
+    else      printCsv(r, seed, ticks, renderEvery);
+  }
+  if (json) printf("  ]\n}\n");
+  return 0;
+}
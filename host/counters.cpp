@@ -0,0 +1,139 @@
+// Hot-path event counter report: runs benchmark scenes and prints, per
+// particle type, how many updates, skips, moves, neighbour probes, random
+// draws and reactions simulate() performed per tick on average.
+//
+//   fsand-counters [--scene NAME|all] [--ticks N] [--seed S]
+//                  [--rng sequential|counter] [--format table|csv]
+//
+// Needs a counter build (make counters, or make host COUNTERS=1); a normal
+// build has no counters to read and exits with status 2.  The table shows
+// the summary columns and the largest reaction; CSV has every counter.
+
+#include "config.h"
+#include "counters.h"
+#include "grid.h"
+#include "physics.h"
+#include "random.h"
+#include "scenes.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef PHYSICS_COUNTERS
+static double perTick(uint64_t n) {
+  return physCountersTicks ? static_cast<double>(n) / physCountersTicks : 0.0;
+}
+
+static uint64_t reactions(int t) {
+  uint64_t n = 0;
+  for (int c = PHYS_REACTION_FIRST; c < PHYS_COUNTER_COUNT; c++)
+    n += physCountersTotal[t][c];
+  return n;
+}
+
+static void printCsvHeader() {
+  printf("scene,type");
+  for (int c = 0; c < PHYS_COUNTER_COUNT; c++) {
+    putchar(',');
+    for (const char *s = PHYS_COUNTER_NAMES[c]; *s; s++) putchar(tolower(*s));
+  }
+  printf("\n");
+}
+
+static void printCsv(const Scene &scene) {
+  for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+    printf("%s,%s", scene.name, PHYS_TYPE_NAMES[t]);
+    for (int c = 0; c < PHYS_COUNTER_COUNT; c++)
+      printf(",%.2f", perTick(physCountersTotal[t][c]));
+    printf("\n");
+  }
+}
+
+static void printTable(const Scene &scene) {
+  printf("%s (%u ticks, per tick)\n", scene.name, physCountersTicks);
+  printf("  %-6s %9s %9s %9s %9s %9s %9s  %s\n",
+         "type", "updates", "skipped", "moves", "probes", "rng", "reactions", "top reaction");
+  for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+    const uint64_t *row = physCountersTotal[t];
+    if (t != static_cast<int>(Particle::AIR) && row[static_cast<int>(PhysCounter::UPDATES)] == 0)
+      continue;
+    int top = -1;
+    for (int c = PHYS_REACTION_FIRST; c < PHYS_COUNTER_COUNT; c++)
+      if (row[c] != 0 && (top < 0 || row[c] > row[top])) top = c;
+    printf("  %-6s %9.1f %9.1f %9.1f %9.1f %9.1f %9.2f  %s\n", PHYS_TYPE_NAMES[t],
+           perTick(row[static_cast<int>(PhysCounter::UPDATES)]),
+           perTick(row[static_cast<int>(PhysCounter::SKIPPED)]),
+           perTick(row[static_cast<int>(PhysCounter::MOVES)]),
+           perTick(row[static_cast<int>(PhysCounter::PROBES)]),
+           perTick(row[static_cast<int>(PhysCounter::RANDOM)]),
+           perTick(reactions(t)),
+           top >= 0 ? PHYS_COUNTER_NAMES[top] : "-");
+  }
+}
+#endif
+
+int main(int argc, char **argv) {
+  const char *sceneName = "all";
+  int ticks = 1000;
+  uint32_t seed = 1;
+  RandomMode rngMode = RandomMode::SEQUENTIAL;
+  bool csv = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+      sceneName = argv[++i];
+    } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+      ticks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    } else if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "sequential") == 0 || strcmp(argv[i + 1], "counter") == 0)) {
+      rngMode = strcmp(argv[++i], "counter") == 0 ? RandomMode::COUNTER : RandomMode::SEQUENTIAL;
+    } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "table") == 0 || strcmp(argv[i + 1], "csv") == 0)) {
+      csv = strcmp(argv[++i], "csv") == 0;
+    } else {
+      fprintf(stderr, "usage: %s [--scene NAME|all] [--ticks N] [--seed S] "
+                      "[--rng sequential|counter] [--format table|csv]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (!PHYSICS_COUNTERS_ENABLED) {
+    fprintf(stderr, "%s: built without PHYSICS_COUNTERS; use 'make counters' "
+                    "or 'make host COUNTERS=1'\n", argv[0]);
+    return 2;
+  }
+
+  const Scene *only = nullptr;
+  if (strcmp(sceneName, "all") != 0) {
+    only = findScene(sceneName);
+    if (!only) {
+      fprintf(stderr, "unknown scene '%s'; available:", sceneName);
+      for (int i = 0; i < SCENE_COUNT; i++) fprintf(stderr, " %s", SCENES[i].name);
+      fprintf(stderr, "\n");
+      return 2;
+    }
+  }
+
+#ifdef PHYSICS_COUNTERS
+  randomSetMode(rngMode, seed);
+  initGrid();
+  if (csv) printCsvHeader();
+  for (int i = 0; i < SCENE_COUNT; i++) {
+    const Scene &scene = SCENES[i];
+    if (only && only != &scene) continue;
+    sceneLoad(scene, seed);
+    physCountersReset();
+    for (int tick = 0; tick < ticks; tick++) simulate();
+    if (csv) printCsv(scene);
+    else     printTable(scene);
+  }
+#else
+  (void)ticks;
+  (void)seed;
+  (void)rngMode;
+  (void)csv;
+#endif
+  return 0;
+}
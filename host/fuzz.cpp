@@ -0,0 +1,440 @@
+// Differential fuzzer: steps the optimised engine (src/simulation.h) and the
+// frozen reference engine (host/reference.cpp) side by side on random small
+// worlds and reports the first cell where they disagree.
+//
+//   fsand-fuzz [--cases N] [--ticks T] [--seed S] [--temp-scale 1|2|4]
+//              [--heat MODE]
+//
+// Each case is a random FuzzWorld of the chosen temperature scale (default
+// the device's TEMP_SCALE) (every Particle type, random coarse
+// temperatures) and a random seed.  Both engines diffuse with the schedule
+// of heat mode MODE (0..HEAT_MODE_MAX, default HEAT_MODE_DEFAULT): its
+// passes and heat hierarchy levels.  The reference visits every cell every
+// tick while the optimised engine skips sleeping ones, so the cases always
+// use the counter-based RNG: there every cell's draws depend only on its
+// position and the tick, and skipping a cell is invisible exactly when its
+// update would have changed nothing — which is what sleep/wake promises.
+// (In sequential mode even a no-op visit would consume the shared stream;
+// golden covers that mode.)  The reference steps the temperature field
+// every tick, so the optimised world runs with sub-cycling off
+// (heatStepMax = 1).  Before every tick the RNG state is saved, the
+// reference engine runs, the state is put back and the optimised engine
+// runs.  After the tick the cells, the temperature field and the RNG state
+// are compared, and the optimised world's incrementally kept material
+// census is checked against a recount of its cells.  Before the cases run,
+// the counter-mode keys of coarse tiles are checked to differ from every
+// cell's.  A diverging case is minimised (cells turned to AIR, tiles set
+// to ambient, as long as it still diverges) and printed as a reproducer.
+// Exit status is 1 if any case diverged.
+
+#include "config.h"
+#include "particle.h"
+#include "random.h"
+#include "reference.h"
+#include "simulation.h"
+#include "world.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+constexpr int FW = FuzzWorld<TEMP_SCALE>::WIDTH;
+constexpr int FH = FuzzWorld<TEMP_SCALE>::HEIGHT;
+
+// A generated starting state
+template <int S>
+struct FuzzCase {
+  uint32_t seed;
+  int heat;  // heat mode: diffusion passes and hierarchy levels
+  Particle cells[FH][FW];
+  uint8_t temperature[FuzzWorld<S>::TEMP_H][FuzzWorld<S>::TEMP_W];
+};
+
+// Where the two engines first disagreed
+struct Divergence {
+  int tick;
+  const char *what;  // "cell", "temperature" or "rng"
+  int x, y;          // cell or tile coordinates
+  int reference, optimised;
+};
+
+// The two engines' worlds at scale S
+template <int S>
+struct FuzzPair {
+  FuzzReference<S> ref;
+  FuzzWorld<S> opt;
+  typename FuzzWorld<S>::Storage optCells;
+};
+
+template <int S>
+static FuzzPair<S> worlds;
+
+template <int S>
+static void load(FuzzWorld<S> &w, typename FuzzWorld<S>::Storage &storage, const FuzzCase<S> &c) {
+  w.attach(storage);
+  w.clear();
+  w.heatPasses = static_cast<uint8_t>(heatModePasses[c.heat]);
+  w.heatLevels = static_cast<uint8_t>(heatModeLevels[c.heat]);
+  w.heatStepMax = 1;
+  for (int y = 0; y < FH; y++)
+    for (int x = 0; x < FW; x++)
+      if (c.cells[y][x] != Particle::AIR) w.setCell(x, y, c.cells[y][x]);
+  memcpy(w.temperature, c.temperature, sizeof(w.temperature));
+}
+
+template <int S>
+static void load(FuzzReference<S> &w, const FuzzCase<S> &c) {
+  w.clear();
+  w.heatPasses = static_cast<uint8_t>(heatModePasses[c.heat]);
+  w.heatLevels = static_cast<uint8_t>(heatModeLevels[c.heat]);
+  for (int y = 0; y < FH; y++)
+    for (int x = 0; x < FW; x++) w.at(x, y) = c.cells[y][x];
+  memcpy(w.temperature, c.temperature, sizeof(w.temperature));
+}
+
+// Run both engines for up to 'ticks' ticks; true (and *d filled in) if they
+// diverge.
+template <int S>
+static bool diverges(const FuzzCase<S> &c, int ticks, Divergence *d) {
+  using Wd = FuzzWorld<S>;
+  FuzzReference<S> &refWorld = worlds<S>.ref;
+  Wd &optWorld = worlds<S>.opt;
+  randomSetMode(RandomMode::COUNTER, c.seed);
+  load(refWorld, c);
+  load(optWorld, worlds<S>.optCells, c);
+  for (int tick = 0; tick < ticks; tick++) {
+    const uint32_t state = xorshift_state;
+    const uint32_t rtick = randomTick;
+    referenceSimulate(refWorld);
+    const uint32_t refState = xorshift_state;
+    xorshift_state = state;
+    randomTick = rtick;
+    simulateWorld(optWorld);
+
+    for (int y = 0; y < FH; y++) {
+      for (int x = 0; x < FW; x++) {
+        const Particle r = refWorld.at(x, y);
+        const Particle o = optWorld.at(x, y);
+        if (r != o) {
+          *d = { tick, "cell", x, y, static_cast<int>(r), static_cast<int>(o) };
+          return true;
+        }
+      }
+    }
+    for (int cy = 0; cy < Wd::TEMP_H; cy++) {
+      for (int cx = 0; cx < Wd::TEMP_W; cx++) {
+        if (refWorld.temperature[cy][cx] != optWorld.temperature[cy][cx]) {
+          *d = { tick, "temperature", cx, cy, refWorld.temperature[cy][cx],
+                 optWorld.temperature[cy][cx] };
+          return true;
+        }
+      }
+    }
+    for (int cy = 0; cy < Wd::TEMP_H; cy++) {
+      for (int cx = 0; cx < Wd::TEMP_W; cx++) {
+        uint32_t expect = 0;
+        for (int dy = 0; dy < Wd::TEMP_SCALE; dy++)
+          for (int dx = 0; dx < Wd::TEMP_SCALE; dx++)
+            expect += CENSUS_UNIT[optWorld.at(cx * Wd::TEMP_SCALE + dx,
+                                              cy * Wd::TEMP_SCALE + dy)];
+        if (optWorld.census[cy][cx] != expect) {
+          *d = { tick, "census", cx, cy, static_cast<int>(expect),
+                 static_cast<int>(optWorld.census[cy][cx]) };
+          return true;
+        }
+      }
+    }
+    if (refState != xorshift_state) {
+      *d = { tick, "rng", 0, 0, static_cast<int>(refState & 0xFFFF),
+             static_cast<int>(xorshift_state & 0xFFFF) };
+      return true;
+    }
+  }
+  return false;
+}
+
+// Particle types of a quiet case: none pins or heats its tile
+static const Particle QUIET_TYPES[] = {
+  Particle::SAND, Particle::WATER, Particle::STONE, Particle::WALL,
+  Particle::PLANT, Particle::STEAM, Particle::ACID,
+};
+constexpr uint32_t QUIET_TYPE_COUNT = sizeof(QUIET_TYPES) / sizeof(QUIET_TYPES[0]);
+
+// Random starting state.  Three cases in four are busy: about a third AIR,
+// the rest spread evenly over the other types, temperatures anywhere in
+// 0..255.  The fourth is quiet, so the thermal spans and wake bits see a
+// mostly settled field: one cell in eight holds a QUIET_TYPES particle,
+// every tile but one lies in the neutral band, and half the time a single
+// LAVA or FIRE particle heats the field up again.
+template <int S>
+static void generate(FuzzCase<S> &c, uint32_t &r) {
+  r = xorshiftStep(r);
+  c.seed = r;
+  r = xorshiftStep(r);
+  const bool quiet = (r & 3u) == 0;
+  for (int y = 0; y < FH; y++) {
+    for (int x = 0; x < FW; x++) {
+      r = xorshiftStep(r);
+      if (quiet) {
+        const uint32_t roll = r % (8u * QUIET_TYPE_COUNT);
+        c.cells[y][x] = roll < QUIET_TYPE_COUNT ? QUIET_TYPES[roll] : Particle::AIR;
+        continue;
+      }
+      const uint32_t roll = r % (3u * (PARTICLE_TYPE_COUNT - 1));
+      c.cells[y][x] = roll < PARTICLE_TYPE_COUNT - 1
+          ? static_cast<Particle>(1 + roll)
+          : Particle::AIR;
+    }
+  }
+  constexpr uint32_t BAND = TEMP_NEUTRAL_MAX - TEMP_NEUTRAL_MIN + 1u;
+  for (int cy = 0; cy < FuzzWorld<S>::TEMP_H; cy++) {
+    for (int cx = 0; cx < FuzzWorld<S>::TEMP_W; cx++) {
+      r = xorshiftStep(r);
+      c.temperature[cy][cx] = quiet
+          ? static_cast<uint8_t>(TEMP_NEUTRAL_MIN + (r >> 8) % BAND)
+          : static_cast<uint8_t>(r >> 24);
+    }
+  }
+  if (quiet) {
+    r = xorshiftStep(r);
+    c.temperature[(r >> 8) % FuzzWorld<S>::TEMP_H][(r >> 16) % FuzzWorld<S>::TEMP_W] =
+        static_cast<uint8_t>(r >> 24);
+    r = xorshiftStep(r);
+    if (r & 1u)
+      c.cells[(r >> 8) % FH][(r >> 16) % FW] = (r & 2u) ? Particle::LAVA : Particle::FIRE;
+  }
+}
+
+// Greedily simplify a diverging case while it keeps diverging within
+// 'ticks' ticks.  Returns the divergence of the minimised case.
+template <int S>
+static Divergence minimise(FuzzCase<S> &c, int ticks, Divergence d) {
+  bool progress = true;
+  for (int round = 0; round < 4 && progress; round++) {
+    progress = false;
+    for (int y = 0; y < FH; y++) {
+      for (int x = 0; x < FW; x++) {
+        const Particle keep = c.cells[y][x];
+        if (keep == Particle::AIR) continue;
+        c.cells[y][x] = Particle::AIR;
+        Divergence nd;
+        if (diverges(c, ticks, &nd)) { d = nd; progress = true; }
+        else c.cells[y][x] = keep;
+      }
+    }
+    for (int cy = 0; cy < FuzzWorld<S>::TEMP_H; cy++) {
+      for (int cx = 0; cx < FuzzWorld<S>::TEMP_W; cx++) {
+        const uint8_t keep = c.temperature[cy][cx];
+        if (keep == TEMP_AMBIENT) continue;
+        c.temperature[cy][cx] = TEMP_AMBIENT;
+        Divergence nd;
+        if (diverges(c, ticks, &nd)) { d = nd; progress = true; }
+        else c.temperature[cy][cx] = keep;
+      }
+    }
+  }
+  return d;
+}
+
+// One character per particle type for the reproducer map
+static const char PARTICLE_GLYPH[PARTICLE_TYPE_COUNT + 1] = ".swo#Lpi~af";
+static_assert(sizeof(PARTICLE_GLYPH) == PARTICLE_TYPE_COUNT + 1,
+              "one glyph per particle type");
+
+template <int S>
+static void printReproducer(int index, const FuzzCase<S> &c, const Divergence &d) {
+  printf("case %d: %s diverged at tick %d, (%d, %d): reference %d, optimised %d\n",
+         index, d.what, d.tick, d.x, d.y, d.reference, d.optimised);
+  printf("  rng counter seed 0x%08x, heat mode %d\n", c.seed, c.heat);
+  printf("  cells (%s):\n", PARTICLE_GLYPH);
+  for (int y = 0; y < FH; y++) {
+    printf("    ");
+    for (int x = 0; x < FW; x++)
+      putchar(PARTICLE_GLYPH[static_cast<int>(c.cells[y][x])]);
+    putchar('\n');
+  }
+  printf("  temperature (1:%d tiles):\n", S);
+  for (int cy = 0; cy < FuzzWorld<S>::TEMP_H; cy++) {
+    printf("    ");
+    for (int cx = 0; cx < FuzzWorld<S>::TEMP_W; cx++)
+      printf(" %3u", c.temperature[cy][cx]);
+    putchar('\n');
+  }
+}
+
+// Counter-mode key of position (x, y) in a tick keyed 'tickKey'
+static uint32_t counterKey(uint32_t tickKey, uint32_t x, uint32_t y) {
+  RandomBits rng = {};
+  rng.counter = true;
+  rng.tickKey = tickKey;
+  rng.at(x, y);
+  return rng.key;
+}
+
+// True if no coarse tile of a W×H world with 'scale' shares its counter-mode
+// key (and so its draws) with any fine cell; prints the first clash.
+static bool tileKeysDistinct(int width, int height, int scale) {
+  constexpr uint32_t TICK_KEY = 0x2545F491u;
+  std::vector<uint32_t> cells;
+  cells.reserve(static_cast<size_t>(width) * height);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      cells.push_back(counterKey(TICK_KEY, x, y));
+  std::sort(cells.begin(), cells.end());
+  for (int cy = 0; cy < height / scale; cy++) {
+    for (int cx = 0; cx < width / scale; cx++) {
+      const uint32_t key = counterKey(TICK_KEY, cx, RANDOM_TILE_DOMAIN | cy);
+      if (std::binary_search(cells.begin(), cells.end(), key)) {
+        printf("%dx%d world: tile (%d, %d) has a cell's counter-mode key %08x\n",
+               width, height, cx, cy, key);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Thermal schedule check.  The reference steps the temperature field every
+// tick, so the cases above run the optimised world with sub-cycling off.
+// Sub-cycling may batch a quiet field's injection, but must not change how
+// far or how evenly heat spreads.  Two device-size worlds start from the
+// same all-AIR field with one hot and one cold tile; one runs sub-cycled,
+// the other stepped every tick.  The sub-cycled world's ambient drift lags
+// by up to a step's waiting ticks, and no tile may end up further apart
+// than that.
+// ---------------------------------------------------------------------------
+
+template <int S>
+using ScheduleWorld = World<GRID_WIDTH, GRID_HEIGHT, S, GRID_UI_BOUNDARY>;
+
+constexpr int SCHEDULE_TICKS = 96;
+constexpr int SCHEDULE_SLACK = TEMP_SUBCYCLE_MAX - 1;
+
+template <int S>
+struct SchedulePair {
+  ScheduleWorld<S> stepped, every;
+  typename ScheduleWorld<S>::Storage steppedCells, everyCells;
+};
+
+template <int S>
+static SchedulePair<S> scheduleWorlds;
+
+template <int S>
+static void loadSchedule(ScheduleWorld<S> &w, typename ScheduleWorld<S>::Storage &storage,
+                         int heat, int stepMax) {
+  using Wd = ScheduleWorld<S>;
+  w.attach(storage);
+  w.clear();
+  w.heatPasses = static_cast<uint8_t>(heatModePasses[heat]);
+  w.heatLevels = static_cast<uint8_t>(heatModeLevels[heat]);
+  w.heatStepMax = static_cast<uint8_t>(stepMax);
+  w.temperature[Wd::TEMP_UI_ROW / 2][Wd::TEMP_W / 3] = 255;
+  w.temperature[Wd::TEMP_UI_ROW / 2][2 * Wd::TEMP_W / 3] = 0;
+  w.thermalMarkAll();
+}
+
+// True if, in heat mode 'heat', the sub-cycled world stays within
+// SCHEDULE_SLACK of the unstepped one on every tile for SCHEDULE_TICKS
+// ticks; prints the first miss
+template <int S>
+static bool scheduleHolds(int heat) {
+  using Wd = ScheduleWorld<S>;
+  SchedulePair<S> &p = scheduleWorlds<S>;
+  randomSetMode(RandomMode::COUNTER, 1);
+  loadSchedule(p.stepped, p.steppedCells, heat, TEMP_SUBCYCLE_MAX);
+  loadSchedule(p.every, p.everyCells, heat, 1);
+  for (int tick = 0; tick < SCHEDULE_TICKS; tick++) {
+    const uint32_t state = xorshift_state;
+    const uint32_t rtick = randomTick;
+    simulateWorld(p.every);
+    xorshift_state = state;
+    randomTick = rtick;
+    simulateWorld(p.stepped);
+    for (int cy = 0; cy < Wd::TEMP_H; cy++) {
+      for (int cx = 0; cx < Wd::TEMP_W; cx++) {
+        const int a = p.every.temperature[cy][cx];
+        const int b = p.stepped.temperature[cy][cx];
+        if (abs(a - b) > SCHEDULE_SLACK) {
+          printf("schedule at 1:%d, heat mode %d: tick %d, tile (%d, %d): "
+                 "every tick %d, sub-cycled %d\n", S, heat, tick, cx, cy, a, b);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Run 'cases' generated cases of 'ticks' ticks at scale S in heat mode
+// 'heat'; the number that diverged
+template <int S>
+static int runCases(int cases, int ticks, uint32_t seed, int heat) {
+  static FuzzCase<S> c;
+  c.heat = heat;
+  uint32_t r = seed != 0 ? seed : 1u;
+  int failed = 0;
+  for (int i = 0; i < cases; i++) {
+    generate(c, r);
+    Divergence d;
+    if (!diverges(c, ticks, &d)) continue;
+    failed++;
+    d = minimise(c, d.tick + 1, d);
+    printReproducer(i, c, d);
+  }
+  return failed;
+}
+
+int main(int argc, char **argv) {
+  int cases = 200;
+  int ticks = 64;
+  uint32_t seed = 1;
+  int scale = TEMP_SCALE;
+  int heat = HEAT_MODE_DEFAULT;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc) {
+      cases = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+      ticks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    } else if (strcmp(argv[i], "--temp-scale") == 0 && i + 1 < argc) {
+      scale = atoi(argv[++i]);
+      if (scale != 1 && scale != 2 && scale != TEMP_SCALE) {
+        fprintf(stderr, "%s: --temp-scale must be 1, 2 or %d\n", argv[0], TEMP_SCALE);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "--heat") == 0 && i + 1 < argc) {
+      heat = atoi(argv[++i]);
+      if (heat < 0 || heat > HEAT_MODE_MAX) {
+        fprintf(stderr, "%s: --heat must be 0..%d\n", argv[0], HEAT_MODE_MAX);
+        return 2;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--cases N] [--ticks T] [--seed S] [--temp-scale 1|2|%d] "
+                      "[--heat MODE]\n", argv[0], TEMP_SCALE);
+      return 2;
+    }
+  }
+
+  // Both engines draw tile randomness in the tile domain; make sure it is
+  // really apart from the cells' for the fuzz, device and large host worlds
+  if (!tileKeysDistinct(FW, FH, scale) ||
+      !tileKeysDistinct(GRID_WIDTH, GRID_HEIGHT, TEMP_SCALE) ||
+      !tileKeysDistinct(1024, 1024, TEMP_SCALE))
+    return 1;
+
+  // The thermal schedule the cases turn off
+  const bool scheduleOk = scale == 1 ? scheduleHolds<1>(heat)
+                        : scale == 2 ? scheduleHolds<2>(heat)
+                                     : scheduleHolds<TEMP_SCALE>(heat);
+  if (!scheduleOk) printf("SCHEDULE FAIL\n");
+
+  const int failed = scale == 1 ? runCases<1>(cases, ticks, seed, heat)
+                   : scale == 2 ? runCases<2>(cases, ticks, seed, heat)
+                                : runCases<TEMP_SCALE>(cases, ticks, seed, heat);
+  printf("%d cases x %d ticks at 1:%d, heat mode %d, %d diverged\n", cases, ticks, scale,
+         heat, failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+// Golden-state regression check: runs every benchmark scene with a fixed
+// seed in each RNG configuration and hashes the simulation state at fixed
+// checkpoints, then compares against the checked-in baseline.
+//
+//   fsand-golden [--baseline FILE] [--update] [--seed S]
+//
+// The hash (64-bit FNV-1a) covers every grid cell, the coarse temperature
+// field and the RNG state (XorShift32 state and tick counter), fed byte by
+// byte in a fixed order so it is the same on any host.  An optimisation is
+// accepted when every checkpoint matches; a deliberate behaviour change is
+// re-baselined with --update, which rewrites the file.  Exit status is 1 on
+// any mismatch.
+
+#include "config.h"
+#include "grid.h"
+#include "physics.h"
+#include "random.h"
+#include "scenes.h"
+#include "settings.h"
+#include "parallel.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+constexpr int CHECKPOINTS[] = { 1, 10, 100, 500 };
+constexpr int CHECKPOINT_COUNT = static_cast<int>(sizeof(CHECKPOINTS) / sizeof(CHECKPOINTS[0]));
+
+// RNG (and heat) configurations every scene runs under
+struct GoldenMode {
+  const char *name;
+  RandomMode rng;
+  int threads;
+  int heat;  // heat propagation mode (settings.h)
+};
+static const GoldenMode MODES[] = {
+  { "sequential", RandomMode::SEQUENTIAL, 1, HEAT_MODE_DEFAULT },
+  { "counter",    RandomMode::COUNTER,    1, HEAT_MODE_DEFAULT },
+  { "parallel",   RandomMode::COUNTER,    2, HEAT_MODE_DEFAULT },
+  { "levels",     RandomMode::SEQUENTIAL, 1, HEAT_MODE_MAX },
+};
+constexpr int MODE_COUNT = static_cast<int>(sizeof(MODES) / sizeof(MODES[0]));
+
+constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ull;
+constexpr uint64_t FNV_PRIME  = 0x00000100000001B3ull;
+
+static uint64_t fnvByte(uint64_t h, uint8_t b) {
+  return (h ^ b) * FNV_PRIME;
+}
+static uint64_t fnvWord(uint64_t h, uint32_t w) {
+  for (int i = 0; i < 4; i++) h = fnvByte(h, static_cast<uint8_t>(w >> (8 * i)));
+  return h;
+}
+
+// Hash of the device world's cells, temperature field and RNG state
+static uint64_t stateHash() {
+  uint64_t h = FNV_OFFSET;
+  for (int y = 0; y < GRID_HEIGHT; y++)
+    for (int x = 0; x < GRID_WIDTH; x++)
+      h = fnvByte(h, static_cast<uint8_t>(grid[y][x]));
+  for (int cy = 0; cy < TEMP_GRID_H; cy++)
+    for (int cx = 0; cx < TEMP_GRID_W; cx++)
+      h = fnvByte(h, temperature[cy][cx]);
+  h = fnvWord(h, xorshift_state);
+  h = fnvWord(h, randomTick);
+  return h;
+}
+
+// One line of the baseline: "<scene> <mode> <tick> <hash>"
+struct GoldenEntry {
+  char scene[32];
+  char mode[16];
+  int tick;
+  uint64_t hash;
+};
+
+constexpr int MAX_ENTRIES = 256;
+static GoldenEntry baseline[MAX_ENTRIES];
+static int baselineCount = 0;
+
+static bool loadBaseline(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[160];
+  while (fgets(line, sizeof(line), f) && baselineCount < MAX_ENTRIES) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    GoldenEntry &e = baseline[baselineCount];
+    if (sscanf(line, "%31s %15s %d %" SCNx64, e.scene, e.mode, &e.tick, &e.hash) == 4)
+      baselineCount++;
+  }
+  fclose(f);
+  return true;
+}
+
+static const GoldenEntry *findEntry(const char *scene, const char *mode, int tick) {
+  for (int i = 0; i < baselineCount; i++) {
+    const GoldenEntry &e = baseline[i];
+    if (e.tick == tick && strcmp(e.scene, scene) == 0 && strcmp(e.mode, mode) == 0)
+      return &e;
+  }
+  return nullptr;
+}
+
+int main(int argc, char **argv) {
+  const char *path = "host/golden.txt";
+  bool update = false;
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      path = argv[++i];
+    } else if (strcmp(argv[i], "--update") == 0) {
+      update = true;
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    } else {
+      fprintf(stderr, "usage: %s [--baseline FILE] [--update] [--seed S]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (!update && !loadBaseline(path)) {
+    fprintf(stderr, "cannot read baseline %s (create it with --update)\n", path);
+    return 2;
+  }
+  FILE *out = nullptr;
+  if (update) {
+    out = fopen(path, "w");
+    if (!out) {
+      fprintf(stderr, "cannot write baseline %s\n", path);
+      return 2;
+    }
+    fprintf(out, "# fsand-golden baseline (seed %u): scene mode tick hash\n"
+                 "# Regenerate with 'make golden-update' only for deliberate behaviour changes.\n",
+            seed);
+  }
+
+  int mismatches = 0;
+  int checked = 0;
+  for (int m = 0; m < MODE_COUNT; m++) {
+    const GoldenMode &mode = MODES[m];
+    randomSetMode(mode.rng, seed);
+    hostParallelSetThreads(mode.threads);
+    setHeatSchedule(heatModePasses[mode.heat], heatModeLevels[mode.heat]);
+    for (int s = 0; s < SCENE_COUNT; s++) {
+      const Scene &scene = SCENES[s];
+      sceneLoad(scene, seed);
+      int tick = 0;
+      for (int c = 0; c < CHECKPOINT_COUNT; c++) {
+        for (; tick < CHECKPOINTS[c]; tick++) simulate();
+        const uint64_t h = stateHash();
+        if (update) {
+          fprintf(out, "%s %s %d %016" PRIx64 "\n", scene.name, mode.name, tick, h);
+          continue;
+        }
+        checked++;
+        const GoldenEntry *e = findEntry(scene.name, mode.name, tick);
+        if (!e) {
+          printf("MISSING  %s %s tick %d: got %016" PRIx64 "\n", scene.name, mode.name, tick, h);
+          mismatches++;
+        } else if (e->hash != h) {
+          printf("MISMATCH %s %s tick %d: expected %016" PRIx64 ", got %016" PRIx64 "\n",
+                 scene.name, mode.name, tick, e->hash, h);
+          mismatches++;
+          break;  // later checkpoints of this run diverge too
+        }
+      }
+    }
+  }
+  hostParallelSetThreads(1);
+
+  if (update) {
+    fclose(out);
+    printf("wrote %s\n", path);
+    return 0;
+  }
+  printf("%d checkpoints checked, %d mismatched\n", checked, mismatches);
+  return mismatches ? 1 : 0;
+}
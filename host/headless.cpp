@@ -0,0 +1,231 @@
+// Headless host runner: drives the simulation core through the SDK shim the
+// same way main.cpp's game loop does, without a display or keyboard.
+//
+//   fsand-headless [--ticks N] [--render-every K] [--rng sequential|counter]
+//                  [--seed S] [--threads T] [--world device|large]
+//                  [--heat MODE] [--temp-scale 1|2|4] [--trace FILE]
+//
+// A small scene is painted through the real input path (swatch taps and
+// touches on the grid), then N physics ticks run with drawGrid() every K ticks.
+// --world large instead tiles that scene across a 1024×1024 LargeWorld and
+// simulates it without rendering, to measure how the tick scales with size.
+// --trace records the run with the performance trace (the 3 key) and writes
+// the blob it saves to MCS to FILE, for fsand-tracedump.  --heat picks the
+// heat propagation mode of the settings screen (0..HEAT_MODE_MAX).
+// --temp-scale 1 or 2 steps a copy of the scene with a finer temperature
+// field (tempscale.h), also without rendering.
+
+#include "config.h"
+#include "grid.h"
+#include "input.h"
+#include "particle.h"
+#include "physics.h"
+#include "random.h"
+#include "renderer.h"
+#include "settings.h"
+#include "simulation.h"
+#include "profiler.h"
+#include "trace.h"
+#include "world.h"
+#include "parallel.h"
+#include "shim.h"
+#include "tempscale.h"
+#include <sdk/os/lcd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Tap the UI swatch for particle 'p' (same hit-test as handleInput()).
+static void selectParticle(Particle p) {
+  for (int j = 0; j < PARTICLE_TYPE_COUNT; j++) {
+    if (PARTICLE_UI_ORDER[j] == p) {
+      hostPushTouch(UI_START_X + j * SWATCH_SPACING + SWATCH_SIZE / 2,
+                    SCREEN_HEIGHT - UI_HEIGHT + SWATCH_SIZE / 2);
+      return;
+    }
+  }
+}
+
+// Paint a horizontal stroke of brush dabs on grid row 'gy' from gx0 to gx1.
+static void stroke(int gx0, int gx1, int gy) {
+  for (int gx = gx0; gx <= gx1; gx += 2)
+    hostPushTouch(gx * PIXEL_SIZE, gy * PIXEL_SIZE);
+}
+
+static void paintDemoScene() {
+  selectParticle(Particle::WALL);
+  stroke(20, 60, 90);
+  stroke(100, 140, 70);
+  selectParticle(Particle::SAND);
+  for (int y = 10; y < 30; y += 3) stroke(25, 55, y);
+  selectParticle(Particle::WATER);
+  for (int y = 10; y < 30; y += 3) stroke(105, 135, y);
+  selectParticle(Particle::LAVA);
+  stroke(70, 90, 20);
+  selectParticle(Particle::PLANT);
+  stroke(30, 50, 88);
+  handleInput();
+}
+
+// Host benchmark world: same kernels as the device, instantiated at 1024×1024
+// with no UI bar.
+using LargeWorld = World<1024, 1024, TEMP_SCALE>;
+static LargeWorld largeWorld;
+static LargeWorld::Storage largeCells;
+
+// Tile the device grid's scene (above its UI wall) across the large world.
+static void tileSceneIntoLargeWorld() {
+  largeWorld.attach(largeCells);
+  largeWorld.clear();
+  for (int y = 0; y < LargeWorld::HEIGHT; y++) {
+    for (int x = 0; x < LargeWorld::WIDTH; x++) {
+      const int sx = x % GRID_WIDTH;
+      const int sy = y % GRID_UI_BOUNDARY;
+      const Particle p = grid[sy][sx];
+      if (p == Particle::AIR) continue;
+      largeWorld.setCell(x, y, p);
+      largeWorld.tempSet(x, y, tempGet(sx, sy));
+    }
+  }
+}
+
+static int countParticles(Particle **g, int width, int height) {
+  int cells = 0;
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      if (g[y][x] != Particle::AIR && g[y][x] != Particle::WALL) cells++;
+  return cells;
+}
+
+int main(int argc, char **argv) {
+  int ticks = 600;
+  int renderEvery = 1;
+  RandomMode rngMode = RandomMode::SEQUENTIAL;
+  uint32_t seed = 0;
+  int threads = 1;
+  bool large = false;
+  int heat = HEAT_MODE_DEFAULT;
+  int tempScale = TEMP_SCALE;
+  const char *tracePath = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+      ticks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--render-every") == 0 && i + 1 < argc) {
+      renderEvery = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "sequential") == 0 || strcmp(argv[i + 1], "counter") == 0)) {
+      rngMode = strcmp(argv[++i], "counter") == 0 ? RandomMode::COUNTER : RandomMode::SEQUENTIAL;
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--world") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "device") == 0 || strcmp(argv[i + 1], "large") == 0)) {
+      large = strcmp(argv[++i], "large") == 0;
+    } else if (strcmp(argv[i], "--heat") == 0 && i + 1 < argc &&
+               atoi(argv[i + 1]) >= 0 && atoi(argv[i + 1]) <= HEAT_MODE_MAX) {
+      heat = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--temp-scale") == 0 && i + 1 < argc &&
+               tempScaleSupported(atoi(argv[i + 1]))) {
+      tempScale = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [--ticks N] [--render-every K] "
+                      "[--rng sequential|counter] [--seed S] [--threads T] "
+                      "[--world device|large] [--heat MODE] [--temp-scale 1|2|4] "
+                      "[--trace FILE]\n", argv[0]);
+      return 2;
+    }
+  }
+  const bool scaled = tempScale != TEMP_SCALE;
+  if (scaled && (large || tracePath)) {
+    fprintf(stderr, "%s: --temp-scale %d cannot be combined with %s\n", argv[0], tempScale,
+            large ? "--world large" : "--trace");
+    return 2;
+  }
+
+  randomSetMode(rngMode, seed);
+  hostParallelSetThreads(threads);  // > 1: parallel simulate(), counter RNG
+  initGrid();
+  initSettings();
+  setHeatSchedule(heatModePasses[heat], heatModeLevels[heat]);
+  tempScaleSelect(tempScale);
+  largeWorld.heatPasses = static_cast<uint8_t>(heatModePasses[heat]);
+  largeWorld.heatLevels = static_cast<uint8_t>(heatModeLevels[heat]);
+  unsigned int width, height;
+  LCD_GetSize(&width, &height);
+  initRenderer(width, height);
+
+  paintDemoScene();
+  if (large) tileSceneIntoLargeWorld();
+  if (scaled) tempScaleLoad();
+
+  if (tracePath && !large) traceStart();
+
+  uint16_t *vram = static_cast<uint16_t *>(LCD_GetVRAMAddress());
+  uint64_t t0 = hostNanos();
+  uint64_t awakeSum = 0;
+  int awakeLast = 0;
+  for (int tick = 0; tick < ticks; tick++) {
+    if (large) {
+      simulateWorld(largeWorld);
+      awakeLast = largeWorld.awakeChunks;
+      awakeSum += static_cast<uint64_t>(awakeLast);
+      continue;
+    }
+    if (scaled) {
+      tempScaleSimulate();
+      awakeLast = tempScaleAwakeChunks();
+      awakeSum += static_cast<uint64_t>(awakeLast);
+      continue;
+    }
+    // Same phase laps as main.cpp's game loop (input is not polled here)
+    const bool profiling = profilerTiming();
+    uint32_t mark = profiling ? getMicros() : 0u;
+    simulate();
+    if (profiling) profilerLap(ProfPhase::SIMULATE, mark);
+    awakeLast = awakeChunkCount;
+    awakeSum += static_cast<uint64_t>(awakeLast);
+    updateFPS();
+    if (profiling) profilerLap(ProfPhase::FPS, mark);
+    const bool rendered = renderEvery > 0 && tick % renderEvery == 0;
+    if (rendered) {
+      drawGrid(vram);
+      if (profiling) profilerLap(ProfPhase::DRAW, mark);
+      LCD_Refresh();
+      if (profiling) profilerLap(ProfPhase::REFRESH, mark);
+    }
+    if (traceRecording) traceRecord(static_cast<uint32_t>(tick), rendered);
+  }
+  uint64_t elapsed = hostNanos() - t0;
+
+  const int cells = large
+      ? countParticles(largeWorld.grid(), LargeWorld::WIDTH, LargeWorld::HEIGHT)
+      : countParticles(tempScaleGrid(), GRID_WIDTH, GRID_HEIGHT);
+  const int chunkCount = large ? LargeWorld::CHUNK_ROWS * LargeWorld::CHUNK_COLS
+                               : CHUNK_ROWS * CHUNK_COLS;
+
+  double secs = static_cast<double>(elapsed) / 1e9;
+  printf("ticks=%d frames=%u particles=%d elapsed_ms=%.3f ticks_per_sec=%.1f "
+         "awake_chunks_avg=%.1f awake_chunks_last=%d/%d\n",
+         ticks, hostRefreshCount(), cells, secs * 1e3,
+         secs > 0.0 ? ticks / secs : 0.0,
+         ticks > 0 ? static_cast<double>(awakeSum) / ticks : 0.0,
+         awakeLast, chunkCount);
+
+  if (tracePath) {
+    const void *blob = nullptr;
+    uint32_t size = 0;
+    FILE *f = nullptr;
+    if (large || !traceStop() || !hostMcsFind("FSandSim", "PerfTrc", &blob, &size) ||
+        !(f = fopen(tracePath, "wb")) || fwrite(blob, 1, size, f) != size) {
+      fprintf(stderr, "cannot write trace to '%s'%s\n", tracePath,
+              large ? " (--trace needs --world device)" : "");
+      if (f) fclose(f);
+      return 1;
+    }
+    fclose(f);
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+#ifndef HOST_SDK_OS_INPUT_H
+#define HOST_SDK_OS_INPUT_H
+
+#include <cstdint>
+
+// Host stand-in for the hollyhock <sdk/os/input.h> header.
+// Only the subset used by src/input.cpp is declared.  GetInput() pops events
+// from a scripted queue filled through hostPushTouch()/hostPushKey() in
+// host/shim.h; an empty queue reports EVENT_NONE, like an idle calculator.
+
+enum Input_EventType : uint16_t {
+  EVENT_NONE       = 0x0000,
+  EVENT_ACTBAR_ESC = 0x0005,
+  EVENT_TOUCH      = 0x0016,
+  EVENT_KEY        = 0x0017,
+};
+
+enum Input_KeyDirection : uint32_t {
+  KEY_PRESSED  = 1,
+  KEY_HELD     = 2,
+  KEY_RELEASED = 4,
+};
+
+enum Input_Keycode : uint32_t {
+  KEYCODE_0 = 0x0030,
+  KEYCODE_1,
+  KEYCODE_2,
+  KEYCODE_3,
+  KEYCODE_4,
+  KEYCODE_5,
+  KEYCODE_6,
+  KEYCODE_7,
+  KEYCODE_8,
+  KEYCODE_9,
+  KEYCODE_PLUS        = 0x002B,
+  KEYCODE_MINUS       = 0x002D,
+  KEYCODE_UP          = 0x0080,
+  KEYCODE_DOWN        = 0x0081,
+  KEYCODE_LEFT        = 0x0082,
+  KEYCODE_RIGHT       = 0x0083,
+  KEYCODE_EXE         = 0x0100,
+  KEYCODE_POWER_CLEAR = 0x0201,
+};
+
+struct Input_Event {
+  Input_EventType type;
+  union {
+    struct {
+      Input_KeyDirection direction;
+      int32_t p1_x;
+      int32_t p1_y;
+    } touch_single;
+    struct {
+      Input_KeyDirection direction;
+      Input_Keycode keyCode;
+    } key;
+  } data;
+};
+
+int GetInput(struct Input_Event *event, uint32_t unknown1, uint32_t unknown2);
+
+#endif // HOST_SDK_OS_INPUT_H
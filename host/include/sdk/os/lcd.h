@@ -0,0 +1,12 @@
+#ifndef HOST_SDK_OS_LCD_H
+#define HOST_SDK_OS_LCD_H
+
+// Host stand-in for the hollyhock <sdk/os/lcd.h> header.
+// VRAM is an in-memory 320×256 RGB565 buffer owned by host/shim.cpp;
+// LCD_Refresh() only counts frames so benchmarks can see how often it ran.
+
+void LCD_GetSize(unsigned int *width, unsigned int *height);
+void *LCD_GetVRAMAddress();
+void LCD_Refresh();
+
+#endif // HOST_SDK_OS_LCD_H
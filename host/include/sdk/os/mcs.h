@@ -0,0 +1,29 @@
+#ifndef HOST_SDK_OS_MCS_H
+#define HOST_SDK_OS_MCS_H
+
+#include <cstdint>
+
+// Host stand-in for the hollyhock <sdk/os/mcs.h> header.
+// Variables live in an in-memory store (host/shim.cpp) that starts empty on
+// every run; hostMcsReset() wipes it between benchmark scenes.
+
+enum MCS_VariableType {
+  VARTYPE_STR = 0x05,
+};
+
+enum MCS_Error {
+  MCS_OK                 = 0,
+  MCS_NO_FOLDER          = 0x40,
+  MCS_FOLDER_EXISTS      = 0x42,
+  MCS_NO_VARIABLE        = 0x33,
+};
+
+enum MCS_Error MCS_CreateFolder(const char *folder, uint8_t *folderIndex);
+enum MCS_Error MCS_SetVariable(const char *folder, const char *name,
+                               enum MCS_VariableType type, uint32_t size,
+                               void *data);
+enum MCS_Error MCS_GetVariable(const char *folder, const char *name,
+                               enum MCS_VariableType *type, char **name2,
+                               void **data, uint32_t *size);
+
+#endif // HOST_SDK_OS_MCS_H
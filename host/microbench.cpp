@@ -0,0 +1,283 @@
+// Kernel micro-benchmarks: times individual physics kernels, the temperature
+// pass, the end-of-tick dirty merge and drawGrid() on controlled
+// neighbourhoods, and reports min / median / p99 per operation.
+//
+//   fsand-microbench [--case NAME|all] [--reps R] [--warmup W] [--format table|csv]
+//
+// Each case has an untimed setup() that rebuilds its neighbourhood before
+// every repetition and a timed run() that performs 'ops' operations (e.g.
+// one kernel call on each of ~50 prepared cells, so single calls are well
+// above the clock's resolution).  The first W repetitions are discarded.
+// Nothing here depends on a benchmark library or on the host beyond
+// benchNanos(), so the same cases can be timed on the device with TMU2.
+
+#include "config.h"
+#include "grid.h"
+#include "particle.h"
+#include "random.h"
+#include "renderer.h"
+#include "scenes.h"
+#include "settings.h"
+#include "simulation.h"
+#include "shim.h"
+#include <sdk/os/lcd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static uint64_t benchNanos() { return hostNanos(); }
+
+// Random bits for the kernels; re-taken from the shared stream per rep
+static RandomBits rng;
+static uint16_t *vram;
+
+// Kernel sites prepared by the current case's setup()
+constexpr int MAX_SITES = GRID_WIDTH;
+static int siteX[MAX_SITES];
+static int siteY[MAX_SITES];
+static int siteCount;
+
+// Empty world with a fresh update bitset and random pool
+static void resetWorld() {
+  initGrid();
+  memset(dirty, 0, sizeof(dirty));
+  rng = randomBegin();
+  siteCount = 0;
+}
+
+static void put(int x, int y, Particle p) {
+  setCell(x, y, p);
+  tempSet(x, y, getParticleTemperature(p));
+}
+
+// Fill [x0..x1]×[y0..y1] (inclusive) with 'p'
+static void fill(int x0, int y0, int x1, int y1, Particle p) {
+  for (int y = y0; y <= y1; y++)
+    for (int x = x0; x <= x1; x++)
+      put(x, y, p);
+}
+
+// Place 'p' every 'step' cells along row y (away from the side walls) and
+// record each as a kernel site.
+static void sites(int y, int step, Particle p) {
+  for (int x = 2; x < GRID_WIDTH - 2 && siteCount < MAX_SITES; x += step) {
+    put(x, y, p);
+    siteX[siteCount] = x;
+    siteY[siteCount] = y;
+    siteCount++;
+  }
+}
+
+// --- Setups ---------------------------------------------------------------
+
+// Sand with open air below: every call falls straight down.
+static void setupSandFall() {
+  resetWorld();
+  sites(40, 3, Particle::SAND);
+}
+
+// Sand resting on a sand bed: every call probes all three cells below.
+static void setupSandRest() {
+  resetWorld();
+  fill(0, 41, GRID_WIDTH - 1, 44, Particle::SAND);
+  sites(40, 1, Particle::SAND);
+}
+
+// Water on a wall floor with air either side: falls blocked, flows sideways.
+static void setupWaterFlow() {
+  resetWorld();
+  fill(0, 41, GRID_WIDTH - 1, 41, Particle::WALL);
+  sites(40, 3, Particle::WATER);
+}
+
+// Lava inside a lava pool: full neighbour scans, no reactions, no flow.
+static void setupLavaPool() {
+  resetWorld();
+  fill(0, 38, GRID_WIDTH - 1, 44, Particle::LAVA);
+  for (int x = 2; x < GRID_WIDTH - 2; x += 3) {
+    siteX[siteCount] = x;
+    siteY[siteCount] = 40;
+    siteCount++;
+  }
+}
+
+// Lava with water on every side: quenches its neighbours to steam.
+static void setupLavaReact() {
+  resetWorld();
+  fill(0, 38, GRID_WIDTH - 1, 42, Particle::WATER);
+  fill(0, 43, GRID_WIDTH - 1, 43, Particle::WALL);
+  sites(40, 3, Particle::LAVA);
+}
+
+// Plant touching water, with air to grow into.
+static void setupPlantWatered() {
+  resetWorld();
+  fill(0, 41, GRID_WIDTH - 1, 41, Particle::WATER);
+  fill(0, 42, GRID_WIDTH - 1, 42, Particle::WALL);
+  sites(40, 3, Particle::PLANT);
+}
+
+// Acid sitting on a sand bed: dissolve rolls on the cell below.
+static void setupAcidDissolve() {
+  resetWorld();
+  fill(0, 41, GRID_WIDTH - 1, 44, Particle::SAND);
+  sites(40, 3, Particle::ACID);
+}
+
+// The lava_water benchmark scene, a realistic mix of hot and cold tiles.
+static void setupTemperature() {
+  sceneLoad(*findScene("lava_water"), 1);
+  rng = randomBegin();
+}
+
+// Every occupied row updated: endTick() merges the whole bitset.
+static void setupDirtyMerge() {
+  memset(updated, 0xFF, sizeof(updated));
+}
+
+// drawGrid() with 0%, ~10% and 100% of the cells dirty on the lava_water
+// scene, so each dirty cell needs a real colour lookup.
+static void setupDraw(uint32_t tenths) {
+  static bool loaded = false;
+  if (!loaded) {
+    sceneLoad(*findScene("lava_water"), 1);
+    loaded = true;
+  }
+  memset(dirty, 0, sizeof(dirty));
+  uint32_t r = 0x9E3779B9u;
+  for (int y = 0; y < GRID_HEIGHT; y++) {
+    for (int x = 0; x < GRID_WIDTH; x++) {
+      r = xorshiftStep(r);
+      if (r % 10u < tenths) dirtySet(x, y);
+    }
+  }
+}
+static void setupDraw0()   { setupDraw(0); }
+static void setupDraw10()  { setupDraw(1); }
+static void setupDraw100() { setupDraw(10); }
+
+// --- Runs -----------------------------------------------------------------
+
+template <void (*Kernel)(DeviceWorld &, int, int, RandomBits &)>
+static void runSites() {
+  for (int i = 0; i < siteCount; i++)
+    Kernel(world, siteX[i], siteY[i], rng);
+}
+
+static void runTemperature() { propagateTemperature(world, rng); }
+static void runDirtyMerge()  { endTick(world); }
+static void runDraw()        { drawGrid(vram); }
+
+// --- Cases ----------------------------------------------------------------
+
+struct MicroCase {
+  const char *name;
+  const char *unit;     // what one operation is
+  void (*setup)();
+  void (*run)();
+  bool perSite;         // ops = siteCount after setup, else 1
+};
+
+static const MicroCase CASES[] = {
+  { "sand_fall",      "updateSand call",   setupSandFall,     runSites<updateSand<DeviceWorld>>,  true },
+  { "sand_rest",      "updateSand call",   setupSandRest,     runSites<updateSand<DeviceWorld>>,  true },
+  { "water_flow",     "updateWater call",  setupWaterFlow,    runSites<updateWater<DeviceWorld>>, true },
+  { "lava_pool",      "updateLava call",   setupLavaPool,     runSites<updateLava<DeviceWorld>>,  true },
+  { "lava_react",     "updateLava call",   setupLavaReact,    runSites<updateLava<DeviceWorld>>,  true },
+  { "plant_watered",  "updatePlant call",  setupPlantWatered, runSites<updatePlant<DeviceWorld>>, true },
+  { "acid_dissolve",  "updateAcid call",   setupAcidDissolve, runSites<updateAcid<DeviceWorld>>,  true },
+  { "temperature",    "propagateTemperature", setupTemperature, runTemperature, false },
+  { "dirty_merge",    "endTick",           setupDirtyMerge,   runDirtyMerge,  false },
+  { "draw_0",         "drawGrid, 0% dirty",   setupDraw0,     runDraw,        false },
+  { "draw_10",        "drawGrid, 10% dirty",  setupDraw10,    runDraw,        false },
+  { "draw_100",       "drawGrid, 100% dirty", setupDraw100,   runDraw,        false },
+};
+constexpr int CASE_COUNT = static_cast<int>(sizeof(CASES) / sizeof(CASES[0]));
+
+struct MicroStats {
+  double minNs, medianNs, p99Ns;
+  int ops;
+};
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double> &sorted, int pct) {
+  size_t rank = (sorted.size() * static_cast<size_t>(pct) + 99) / 100;
+  if (rank == 0) rank = 1;
+  return sorted[rank - 1];
+}
+
+static MicroStats measure(const MicroCase &c, int reps, int warmup) {
+  std::vector<double> samples;
+  samples.reserve(static_cast<size_t>(reps));
+  int ops = 1;
+  for (int rep = 0; rep < warmup + reps; rep++) {
+    c.setup();
+    ops = c.perSite ? siteCount : 1;
+    const uint64_t t0 = benchNanos();
+    c.run();
+    const uint64_t t1 = benchNanos();
+    if (rep >= warmup)
+      samples.push_back(static_cast<double>(t1 - t0) / ops);
+  }
+  std::sort(samples.begin(), samples.end());
+  return { samples.front(), percentile(samples, 50), percentile(samples, 99), ops };
+}
+
+int main(int argc, char **argv) {
+  const char *caseName = "all";
+  int reps = 200;
+  int warmup = 20;
+  bool csv = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--case") == 0 && i + 1 < argc) {
+      caseName = argv[++i];
+    } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+      reps = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+      warmup = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc &&
+               (strcmp(argv[i + 1], "table") == 0 || strcmp(argv[i + 1], "csv") == 0)) {
+      csv = strcmp(argv[++i], "csv") == 0;
+    } else {
+      fprintf(stderr, "usage: %s [--case NAME|all] [--reps R] [--warmup W] "
+                      "[--format table|csv]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (reps < 1) reps = 1;
+  if (warmup < 0) warmup = 0;
+
+  bool found = strcmp(caseName, "all") == 0;
+  for (int i = 0; i < CASE_COUNT && !found; i++)
+    found = strcmp(CASES[i].name, caseName) == 0;
+  if (!found) {
+    fprintf(stderr, "unknown case '%s'; available:", caseName);
+    for (int i = 0; i < CASE_COUNT; i++) fprintf(stderr, " %s", CASES[i].name);
+    fprintf(stderr, "\n");
+    return 2;
+  }
+
+  randomSetMode(RandomMode::SEQUENTIAL, 1);
+  initGrid();
+  initSettings();
+  unsigned int width, height;
+  LCD_GetSize(&width, &height);
+  initRenderer(width, height);
+  vram = static_cast<uint16_t *>(LCD_GetVRAMAddress());
+
+  if (csv) printf("case,operation,ops_per_rep,reps,min_ns,median_ns,p99_ns\n");
+  else     printf("%-14s %-22s %5s %10s %10s %10s\n",
+                  "case", "per", "ops", "min_ns", "median_ns", "p99_ns");
+  for (int i = 0; i < CASE_COUNT; i++) {
+    const MicroCase &c = CASES[i];
+    if (strcmp(caseName, "all") != 0 && strcmp(caseName, c.name) != 0) continue;
+    const MicroStats s = measure(c, reps, warmup);
+    if (csv) printf("%s,%s,%d,%d,%.1f,%.1f,%.1f\n",
+                    c.name, c.unit, s.ops, reps, s.minNs, s.medianNs, s.p99Ns);
+    else     printf("%-14s %-22s %5d %10.1f %10.1f %10.1f\n",
+                    c.name, c.unit, s.ops, s.minNs, s.medianNs, s.p99Ns);
+  }
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include "parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One thread's share of the current job: [begin, end) packed into a single
+// 64-bit word so the owner's pop-front and a thief's steal-back are each one
+// compare-and-swap.  Padded to a cache line so owners don't false-share.
+struct alignas(64) WorkRange {
+  std::atomic<uint64_t> span{0};
+};
+
+static inline uint64_t packSpan(uint32_t begin, uint32_t end) {
+  return (static_cast<uint64_t>(end) << 32) | begin;
+}
+static inline uint32_t spanBegin(uint64_t s) { return static_cast<uint32_t>(s); }
+static inline uint32_t spanEnd(uint64_t s)   { return static_cast<uint32_t>(s >> 32); }
+
+class WorkerPool {
+ public:
+  explicit WorkerPool(int threads) : ranges_(threads) {
+    for (int i = 1; i < threads; i++)
+      workers_.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &t : workers_) t.join();
+  }
+
+  int threads() const { return static_cast<int>(ranges_.size()); }
+
+  void run(int count, ParallelBody body, void *ctx) {
+    if (count <= 0) return;
+    // Every worker takes part in every job exactly once and the job is over
+    // only when all of them have left work(), so no worker can still be
+    // stealing from the previous job's ranges while these are rewritten.
+    body_ = body;
+    ctx_ = ctx;
+    const uint32_t n = static_cast<uint32_t>(ranges_.size());
+    for (uint32_t i = 0; i < n; i++) {
+      const uint32_t b = static_cast<uint32_t>(count) * i / n;
+      const uint32_t e = static_cast<uint32_t>(count) * (i + 1) / n;
+      ranges_[i].span.store(packSpan(b, e), std::memory_order_relaxed);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      active_.store(static_cast<int>(n) - 1, std::memory_order_relaxed);
+      generation_++;
+    }
+    wake_.notify_all();
+
+    work(0);
+    // Stolen items may still be running on other threads.
+    while (active_.load(std::memory_order_acquire) != 0)
+      std::this_thread::yield();
+  }
+
+ private:
+  // Pop one index from the front of range 'self'.
+  bool popFront(uint32_t self, uint32_t &index) {
+    std::atomic<uint64_t> &span = ranges_[self].span;
+    uint64_t s = span.load(std::memory_order_acquire);
+    while (spanBegin(s) < spanEnd(s)) {
+      if (span.compare_exchange_weak(s, packSpan(spanBegin(s) + 1, spanEnd(s)),
+                                     std::memory_order_acq_rel)) {
+        index = spanBegin(s);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Move the back half of some other thread's range into range 'self'
+  // (which is empty, so only thieves can be looking at it).
+  bool steal(uint32_t self) {
+    const uint32_t n = static_cast<uint32_t>(ranges_.size());
+    for (uint32_t k = 1; k < n; k++) {
+      std::atomic<uint64_t> &victim = ranges_[(self + k) % n].span;
+      uint64_t s = victim.load(std::memory_order_acquire);
+      while (spanBegin(s) < spanEnd(s)) {
+        const uint32_t mid = spanEnd(s) - (spanEnd(s) - spanBegin(s) + 1) / 2;
+        if (victim.compare_exchange_weak(s, packSpan(spanBegin(s), mid),
+                                         std::memory_order_acq_rel)) {
+          ranges_[self].span.store(packSpan(mid, spanEnd(s)), std::memory_order_release);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void work(uint32_t self) {
+    uint32_t index;
+    for (;;) {
+      while (popFront(self, index))
+        body_(static_cast<int>(index), ctx_);
+      if (!steal(self)) return;
+    }
+  }
+
+  void workerLoop(int self) {
+    uint64_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+      }
+      work(static_cast<uint32_t>(self));
+      active_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+
+  std::vector<WorkRange> ranges_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+  ParallelBody body_ = nullptr;
+  void *ctx_ = nullptr;
+  std::atomic<int> active_{0};  // workers still inside the current job
+};
+
+static WorkerPool *pool = nullptr;
+
+void hostParallelSetThreads(int threads) {
+  if (threads < 1) threads = 1;
+  if (hostParallelThreads() == threads) return;
+  delete pool;
+  pool = threads > 1 ? new WorkerPool(threads) : nullptr;
+}
+
+int hostParallelThreads() {
+  return pool ? pool->threads() : 1;
+}
+
+void hostParallelFor(int count, ParallelBody body, void *ctx) {
+  if (!pool) {
+    for (int i = 0; i < count; i++) body(i, ctx);
+    return;
+  }
+  pool->run(count, body, ctx);
+}
@@ -0,0 +1,26 @@
+#ifndef HOST_PARALLEL_H
+#define HOST_PARALLEL_H
+
+// ---------------------------------------------------------------------------
+// Host-only work-stealing thread pool behind the parallel simulate() mode.
+//
+// hostParallelFor() splits [0, count) into one contiguous range per thread.
+// Each thread pops indices from the front of its own range; a thread that
+// runs dry steals the back half of another thread's range.  The calling
+// thread takes part, so N threads means N - 1 pool workers.
+//
+// With fewer than 2 threads (the default) simulate() runs the original
+// single-threaded scan; hostParallelSetThreads(1) is the fall-back switch.
+// ---------------------------------------------------------------------------
+
+using ParallelBody = void (*)(int index, void *ctx);
+
+// Resize the pool.  threads <= 1 stops all workers.
+void hostParallelSetThreads(int threads);
+// Current thread count (1 when the pool is off).
+int hostParallelThreads();
+// Run body(i, ctx) for every i in [0, count) and return once all are done.
+// Must only be called from one thread at a time.
+void hostParallelFor(int count, ParallelBody body, void *ctx);
+
+#endif // HOST_PARALLEL_H
@@ -0,0 +1,784 @@
+// Frozen reference engine for differential testing (see fuzz.cpp).
+//
+// The serial simulation kernels from src/simulation.h as they stood when the
+// fuzzer was introduced, on a plain world of its own (ReferenceWorld): every
+// cell of every row is visited and every tile stepped every tick, with no
+// sleep/wake chunks, occupancy bitset, material census, thermal spans, wake
+// bits or thermal sub-cycling, so the optimised engine's bookkeeping is
+// checked rather than shared.  Do NOT
+// optimise or refactor this file: its job
+// is to stay the straightforward definition of the rules that rewrites of
+// simulation.h are checked against.  Change it only for deliberate rule
+// changes, together with the matching change in simulation.h (and a golden
+// re-baseline).
+//
+// Kept in its own translation unit: its static kernels share their names
+// with simulation.h's, so the two must never be included together.
+
+#include "reference.h"
+#include "config.h"
+#include "particle.h"
+#include "random.h"
+#include "world.h"
+#include <cstring>
+
+// Check if a particle should update this frame based on its fall speed.
+// Fall speeds MUST be powers of 2 (enforced by static_assert in config.h) so
+// the table stores log2(FALL_SPEED) and a 1-in-FALL_SPEED roll is that many
+// pool bits being zero — no integer division, which `%` compiles to on SH4
+// (no hardware divide — a software call).
+static inline bool shouldUpdate(Particle p, RandomBits& rng) {
+  const uint32_t fallBits = particleProps[p].fallBits;
+  if (fallBits == 0) return true;  // skip the draw for always-update particles
+  return rng.bits(fallBits) == 0;
+}
+
+// Table-driven phase change for the particle 'p' at (x, y): if the coarse
+// tile is past the type's cold or hot threshold, roll the per-type chance and
+// convert.  The tile takes the new type's default temperature (AIR carries
+// none, so burnt-away plant leaves the heat where it is).  Always called with
+// a constant 'p', so the PARTICLE_PROPS fields fold to immediates.
+// Returns true if the particle changed and the kernel must stop.
+template <class Wd>
+static inline bool tryPhaseChange(Wd& w, int x, int y, Particle p, RandomBits& rng) {
+  const ParticleProps& pp = PARTICLE_PROPS[p];
+  Particle into = p;
+  if (pp.coldInto != p && w.tempGet(x, y) <= pp.coldAt &&
+      rng.bits(pp.coldBits) == 0) {
+    into = pp.coldInto;
+  } else if (pp.hotInto != p && w.tempGet(x, y) >= pp.hotAt &&
+             rng.bits(pp.hotBits) == 0) {
+    into = pp.hotInto;
+  }
+  if (into == p) return false;
+  w.setCell(x, y, into);
+  if (into != Particle::AIR) w.tempSet(x, y, PARTICLE_PROPS[into].temperature);
+  return true;
+}
+
+// Step 2 of propagateTemperature() for coarse tile (cx, cy): inject sources
+// and sinks from the particles actually in the tile.  Touches only this
+// tile's temperature.
+template <class Wd>
+static inline void injectTile(Wd& w, int cx, int cy, RandomBits& rng) {
+  const int fineX0 = cx * Wd::TEMP_SCALE;
+  const int fineY0 = cy * Wd::TEMP_SCALE;
+  bool hasLava  = false;
+  bool hasFire  = false;
+  bool hasWater = false;
+  bool hasIce   = false;
+  int  wallCount = 0;
+  int  airCount  = 0;
+  for (int dy = 0; dy < Wd::TEMP_SCALE; dy++) {
+    for (int dx = 0; dx < Wd::TEMP_SCALE; dx++) {
+      Particle p = w.at(fineX0 + dx, fineY0 + dy);
+      if      (p == Particle::LAVA)  { hasLava = true; }
+      else if (p == Particle::FIRE)  { hasFire = true; }
+      else if (p == Particle::ICE)   { hasIce  = true; }
+      else if (p == Particle::WALL)  { wallCount++; }
+      else if (p == Particle::WATER) { hasWater = true; }
+      else if (p == Particle::AIR)   { airCount++; }
+    }
+  }
+  const bool allWall = (wallCount == Wd::TEMP_SCALE * Wd::TEMP_SCALE);
+  if (hasLava) {
+    // Lava pins its tile to maximum heat — it is a continuous heat source.
+    w.temperature[cy][cx] = TEMP_LAVA;
+  } else if (hasFire) {
+    // Fire heats its tile toward TEMP_FIRE (220) — strong but not instant like lava.
+    int t = static_cast<int>(w.temperature[cy][cx]);
+    if (t < TEMP_FIRE) t += 4;
+    if (t > TEMP_FIRE) t = TEMP_FIRE;
+    w.temperature[cy][cx] = static_cast<uint8_t>(t);
+  } else if (allWall) {
+    // Entirely-wall tile: thermal insulator, always ambient.
+    w.temperature[cy][cx] = TEMP_AMBIENT;
+  } else if (hasIce) {
+    // ICE is a continuous cold source — pins tile to minimum cold.
+    w.temperature[cy][cx] = TEMP_ICE_SURFACE;
+  } else {
+    // Context-aware cooling:
+    //  • Water present  → aggressively cool toward TEMP_COLD
+    //  • Air present    → slow drift toward TEMP_AMBIENT (1/tick)
+    //  • Buried (solid) → negligible cooling (1-in-16 chance)
+    int t = static_cast<int>(w.temperature[cy][cx]);
+    if (hasWater) {
+      t -= TEMP_WATER_COOL_RATE;
+      if (t < TEMP_COLD) t = TEMP_COLD;
+    } else if (airCount > 0) {
+      if      (t > TEMP_AMBIENT) t--;
+      else if (t < TEMP_AMBIENT) t++;
+    } else {
+      // Buried — very slowly return to ambient
+      rng.at(cx, RANDOM_TILE_DOMAIN | cy);
+      if (t != TEMP_AMBIENT && rng.chance(TEMP_BURIED_COOL_MASK)) {
+        if (t > TEMP_AMBIENT) t--;
+        else                  t++;
+      }
+    }
+    w.temperature[cy][cx] = static_cast<uint8_t>(t);
+  }
+  // (no separate comment needed — cooling handled above)
+}
+
+// A level of the heat hierarchy: a grid of up to TEMP_W × TEMP_H values,
+// of which the top-left lw × lh are in use
+template <class Wd>
+using Level = uint8_t[Wd::TEMP_H][Wd::TEMP_W];
+
+// Level 'g' (lw × lh) from the grid above it: each value is the rounded
+// average of a 2×2 block of 'fine'
+template <class Wd>
+static void restrictLevel(const Level<Wd>& fine, Level<Wd>& g, int lw, int lh) {
+  for (int y = 0; y < lh; y++)
+    for (int x = 0; x < lw; x++)
+      g[y][x] = static_cast<uint8_t>((fine[2 * y][2 * x] + fine[2 * y][2 * x + 1] +
+                                      fine[2 * y + 1][2 * x] + fine[2 * y + 1][2 * x + 1] + 2) >> 2);
+}
+
+// One Jacobi blend of level 'g' (lw × lh), with the field's weights and
+// edge clamping, rounded to nearest
+template <class Wd>
+static void blendLevel(Level<Wd>& g, int lw, int lh) {
+  Level<Wd> prev;
+  memcpy(prev, g, sizeof(prev));
+  for (int y = 0; y < lh; y++) {
+    for (int x = 0; x < lw; x++) {
+      int t = prev[y][x];
+      int tL = (x > 0)      ? (int)prev[y][x - 1] : t;
+      int tR = (x < lw - 1) ? (int)prev[y][x + 1] : t;
+      int tU = (y > 0)      ? (int)prev[y - 1][x] : t;
+      int tD = (y < lh - 1) ? (int)prev[y + 1][x] : t;
+      g[y][x] = static_cast<uint8_t>(((t << 2) + tL + tR + tU + tD + 4) >> 3);
+    }
+  }
+}
+
+// Add the change of each value of level 'g' (lw × lh, 'before' as it was
+// restricted) to the 2×2 block it covers in 'fine', clamped to 0..255
+template <class Wd>
+static void prolongLevel(Level<Wd>& fine, const Level<Wd>& g, const Level<Wd>& before,
+                         int lw, int lh) {
+  for (int y = 0; y < 2 * lh; y++) {
+    for (int x = 0; x < 2 * lw; x++) {
+      int t = fine[y][x] + g[y / 2][x / 2] - before[y / 2][x / 2];
+      if (t < 0)   t = 0;
+      if (t > 255) t = 255;
+      fine[y][x] = static_cast<uint8_t>(t);
+    }
+  }
+}
+
+// Propagate temperature: diffuse heat between coarse cells then re-inject
+// particle-sourced heat/cold, every tick.
+template <class Wd>
+static void propagateTemperature(Wd& w, RandomBits& rng) {
+  // --- Step 1: Diffusion ---
+  // Run w.heatPasses passes (TEMP_DIFFUSION_PASSES by default) so heat
+  // spreads that many coarse cells per tick.
+  // Each pass: blend with 4-neighbour average using power-of-2 divisor so
+  // the SH4 (no hardware divide) can use a cheap right-shift instead.
+  // Weights: self×4 + each present neighbour×1, then >>3 (÷8).
+  // Each pass reads the field as it stood before the pass (Jacobi), so the
+  // result does not depend on sweep order.
+  // Pure diffusion — cooling is applied per-tile in Step 2 where we know
+  // the context (air / water / buried).
+  for (int pass = 0; pass < w.heatPasses; pass++) {
+    uint8_t prev[Wd::TEMP_H][Wd::TEMP_W];
+    memcpy(prev, w.temperature, sizeof(prev));
+    for (int cy = 0; cy < Wd::TEMP_H; cy++) {
+      for (int cx = 0; cx < Wd::TEMP_W; cx++) {
+        int t = prev[cy][cx];
+        // Clamp missing edge neighbours to the cell's own value so absent
+        // borders don't artificially cool/heat edge cells.
+        int tL = (cx > 0)              ? (int)prev[cy][cx - 1] : t;
+        int tR = (cx < Wd::TEMP_W - 1) ? (int)prev[cy][cx + 1] : t;
+        int tU = (cy > 0)              ? (int)prev[cy - 1][cx] : t;
+        int tD = (cy < Wd::TEMP_H - 1) ? (int)prev[cy + 1][cx] : t;
+        // Always exactly 8 contributions → safe power-of-2 shift
+        w.temperature[cy][cx] = static_cast<uint8_t>(((t << 2) + tL + tR + tU + tD) >> 3);
+      }
+    }
+  }
+
+  // Then levels 1 .. w.heatLevels - 1 of the heat hierarchy: level l holds
+  // the averages of 2^l × 2^l blocks of tiles.  Each level is blended once,
+  // deepest first, and what the blend changed is added back to the level
+  // above (level 0 being the field).
+  if (w.heatLevels > 1) {
+    const int w1 = Wd::TEMP_W / 2, h1 = Wd::TEMP_H / 2;
+    Level<Wd> level1, start1;
+    restrictLevel<Wd>(w.temperature, level1, w1, h1);
+    memcpy(start1, level1, sizeof(start1));
+    if (w.heatLevels > 2) {
+      const int w2 = w1 / 2, h2 = h1 / 2;
+      Level<Wd> level2, start2;
+      restrictLevel<Wd>(level1, level2, w2, h2);
+      memcpy(start2, level2, sizeof(start2));
+      blendLevel<Wd>(level2, w2, h2);
+      prolongLevel<Wd>(level1, level2, start2, w2, h2);
+    }
+    blendLevel<Wd>(level1, w1, h1);
+    prolongLevel<Wd>(w.temperature, level1, start1, w1, h1);
+  }
+
+  // --- Step 2: Inject sources / sinks from actual particles ---
+  // Only process coarse rows above the UI zone; rows at or below
+  // Wd::TEMP_UI_ROW are always pinned to TEMP_AMBIENT (cleared below).
+  for (int cy = 0; cy < Wd::TEMP_UI_ROW; cy++)
+    for (int cx = 0; cx < Wd::TEMP_W; cx++)
+      injectTile(w, cx, cy, rng);
+
+  // Pin UI-zone coarse rows to TEMP_AMBIENT so heat never bleeds behind
+  // the particle-selector bar.
+  w.pinUiTemperature();
+}
+
+// Update sand particle
+template <class Wd>
+static void updateSand(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: sustained heat (from nearby lava) converts sand to stone
+  if (tryPhaseChange(w, x, y, Particle::SAND, rng)) return;
+
+  // Try to fall straight down
+  if (w.canMoveTo(x, y + 1, Particle::SAND)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  else {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::SAND)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+    }
+    else if (w.canMoveTo(x + d2, y + 1, Particle::SAND)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+    }
+  }
+}
+
+// Update water particle
+template <class Wd>
+static void updateWater(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: freezing cold converts water to ice; high heat evaporates
+  // it into hot steam that carries the heat away
+  if (tryPhaseChange(w, x, y, Particle::WATER, rng)) return;
+
+  // Try to fall straight down (only into empty space)
+  if (w.canMoveTo(x, y + 1, Particle::WATER)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+    return;
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::WATER)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+      return;
+    }
+    if (w.canMoveTo(x + d2, y + 1, Particle::WATER)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+      return;
+    }
+  }
+  // Blocked below — try to flow sideways; randomize direction for balanced spreading
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int dir1 = tryLeftFirst ? -1 : 1;
+    int dir2 = -dir1;
+
+    if (w.canMoveTo(x + dir1, y, Particle::WATER)) {
+      w.swap(x, y, x + dir1, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir1, y);
+    }
+    else if (w.canMoveTo(x + dir2, y, Particle::WATER)) {
+      w.swap(x, y, x + dir2, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir2, y);
+    }
+  }
+}
+
+// Update stone particle (just falls, no sideways movement)
+template <class Wd>
+static void updateStone(Wd& w, int x, int y, RandomBits& rng) {
+  // Stone submerged in extreme heat (needs multiple nearby lava cells to
+  // push the coarse tile past TEMP_STONE_MELT) slowly melts back to lava.
+  if (tryPhaseChange(w, x, y, Particle::STONE, rng)) return;
+
+  if (w.canMoveTo(x, y + 1, Particle::STONE)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+}
+// Update ice particle — falls like sand, melts to water in warmth
+template <class Wd>
+static void updateIce(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: warmth melts ice back to water
+  if (tryPhaseChange(w, x, y, Particle::ICE, rng)) return;
+
+  // Try to fall straight down (can displace water)
+  if (w.canMoveTo(x, y + 1, Particle::ICE)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  else {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::ICE)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+    }
+    else if (w.canMoveTo(x + d2, y + 1, Particle::ICE)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+    }
+  }
+}
+
+template <class Wd>
+static void updateLava(Wd& w, int x, int y, RandomBits& rng) {
+  // Isolated lava (no adjacent lava cell) slowly solidifies into stone,
+  // modelling a thin tendril of lava losing heat to its surroundings.
+  // Lava inside a larger pool (has neighbours) stays molten indefinitely.
+  bool hasAdjacentLava = false;
+  for (int dy = -1; dy <= 1 && !hasAdjacentLava; dy++) {
+    for (int dx = -1; dx <= 1 && !hasAdjacentLava; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      if (w.at(x + dx, y + dy) == Particle::LAVA)
+        hasAdjacentLava = true;
+    }
+  }
+  // Low probability so solidification takes many seconds, not instant.
+  // Also require the coarse tile has cooled somewhat (water quenching is
+  // the main fast-solidification path).
+  if (!hasAdjacentLava && w.tempGet(x, y) < TEMP_LAVA &&
+      rng.chance(0xFFu)) {
+    w.setCell(x, y, Particle::STONE);
+    return;
+  }
+
+  // Check and convert adjacent particles
+  // Check all 8 neighbors for sand/water/plant
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      int nx = x + dx;
+      int ny = y + dy;
+      if (w.at(nx, ny) == Particle::SAND) {
+        w.setCell(nx, ny, Particle::STONE);
+        w.updatedSet(nx, ny);
+      } else if (w.at(nx, ny) == Particle::WATER) {
+        w.setCell(nx, ny, Particle::STEAM);  // Lava quenches water → hot steam
+        w.tempSet(nx, ny, TEMP_STEAM);
+        w.updatedSet(nx, ny);
+      } else if (w.at(nx, ny) == Particle::ICE) {
+        w.setCell(nx, ny, Particle::WATER);  // Lava melts ice
+        w.tempSet(nx, ny, TEMP_AMBIENT);
+        w.updatedSet(nx, ny);
+      } else if (w.at(nx, ny) == Particle::PLANT) {
+        w.setCell(nx, ny, Particle::STEAM);  // Burning plant → steam/smoke
+        w.tempSet(nx, ny, TEMP_STEAM);
+        w.updatedSet(nx, ny);
+      }
+    }
+  }
+  
+  // Lava occasionally emits fire particles directly above — glowing sparks
+  if (w.at(x, y - 1) == Particle::AIR && rng.chance(0x3Fu)) {
+    w.setCell(x, y - 1, Particle::FIRE);
+    w.tempSet(x, y - 1, TEMP_FIRE);
+    w.updatedSet(x, y - 1);
+  }
+
+  // Lava flows like water but slower
+  if (w.canMoveTo(x, y + 1, Particle::LAVA)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+  // Try diagonal down-left
+  else if (w.canMoveTo(x - 1, y + 1, Particle::LAVA)) {
+    w.swap(x, y, x - 1, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x - 1, y + 1);
+  }
+  // Try diagonal down-right
+  else if (w.canMoveTo(x + 1, y + 1, Particle::LAVA)) {
+    w.swap(x, y, x + 1, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + 1, y + 1);
+  }
+  // Occasionally flow sideways (power-of-2 mask — no software divide)
+  else if (rng.chance(LAVA_FLOW_CHANCE - 1)) {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int dir1 = tryLeftFirst ? -1 : 1;
+    int dir2 = -dir1;
+    if (w.canMoveTo(x + dir1, y, Particle::LAVA)) {
+      w.swap(x, y, x + dir1, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir1, y);
+    }
+    else if (w.canMoveTo(x + dir2, y, Particle::LAVA)) {
+      w.swap(x, y, x + dir2, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir2, y);
+    }
+  }
+}
+
+// Update acid particle: dissolves SAND, STONE, PLANT, and ICE on contact;
+// flows like water.  Each dissolved cell has a 1-in-4 chance to also consume
+// the acid cell (acid is finite).
+template <class Wd>
+static void updateAcid(Wd& w, int x, int y, RandomBits& rng) {
+  // Orthogonal neighbour offsets
+  static const int8_t ndx[4] = {  0,  0, -1,  1 };
+  static const int8_t ndy[4] = { -1,  1,  0,  0 };
+
+  bool consumed = false;
+  for (int i = 0; i < 4 && !consumed; i++) {
+    int nx = x + ndx[i];
+    int ny = y + ndy[i];
+    Particle nb = w.at(nx, ny);
+
+    bool dissolveToAir   = (nb == Particle::SAND  ||
+                            nb == Particle::STONE ||
+                            nb == Particle::PLANT);
+    bool dissolveIceToWater = (nb == Particle::ICE);
+
+    if ((dissolveToAir || dissolveIceToWater) &&
+        rng.chance(ACID_DISSOLVE_MASK)) {
+      if (dissolveIceToWater) {
+        w.setCell(nx, ny, Particle::WATER);
+        w.tempSet(nx, ny, TEMP_COLD);
+      } else {
+        w.setCell(nx, ny, Particle::AIR);
+      }
+      // Acid is consumed by the reaction with some probability
+      if (rng.chance(ACID_CONSUME_MASK)) {
+        w.setCell(x, y, Particle::AIR);
+        consumed = true;
+      }
+    }
+  }
+  if (consumed) return;
+  // Flow like water: fall, then spread sideways
+  if (w.canMoveTo(x, y + 1, Particle::ACID)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+    return;
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::ACID)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+      return;
+    }
+    if (w.canMoveTo(x + d2, y + 1, Particle::ACID)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+      return;
+    }
+  }
+  // Blocked below — spread sideways
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int dir1 = tryLeftFirst ? -1 : 1;
+    int dir2 = -dir1;
+    if (w.canMoveTo(x + dir1, y, Particle::ACID)) {
+      w.swap(x, y, x + dir1, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir1, y);
+    } else if (w.canMoveTo(x + dir2, y, Particle::ACID)) {
+      w.swap(x, y, x + dir2, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir2, y);
+    }
+  }
+}
+
+// Update fire particle: rises, ignites PLANT neighbours, is quenched by WATER,
+// and burns out probabilistically into STEAM (smoke) or AIR.
+template <class Wd>
+static void updateFire(Wd& w, int x, int y, RandomBits& rng) {
+  // Burns out probabilistically
+  if (rng.chance(FIRE_BURNOUT_MASK)) {
+    if (rng.bits(1)) {
+      w.setCell(x, y, Particle::STEAM);
+      w.tempSet(x, y, TEMP_STEAM);
+    } else {
+      w.setCell(x, y, Particle::AIR);
+    }
+    w.updatedSet(x, y);
+    return;
+  }
+
+  // Interact with orthogonal neighbours
+  static const int8_t fndx[4] = {  0,  0, -1,  1 };
+  static const int8_t fndy[4] = { -1,  1,  0,  0 };
+  for (int i = 0; i < 4; i++) {
+    int nx = x + fndx[i];
+    int ny = y + fndy[i];
+    Particle nb = w.at(nx, ny);
+
+    // Water quenches fire: both become STEAM
+    if (nb == Particle::WATER) {
+      w.setCell(x, y, Particle::STEAM);
+      w.setCell(nx, ny, Particle::STEAM);
+      w.tempSet(x,  y,  TEMP_STEAM);
+      w.tempSet(nx, ny, TEMP_STEAM);
+      w.updatedSet(x, y);
+      w.updatedSet(nx, ny);
+      return;
+    }
+
+    // Ignite adjacent PLANT (probabilistic spread)
+    if (nb == Particle::PLANT && rng.chance(FIRE_SPREAD_MASK)) {
+      w.setCell(nx, ny, Particle::FIRE);
+      w.tempSet(nx, ny, TEMP_FIRE);
+      w.updatedSet(nx, ny);
+    }
+  }
+
+  // Rise upward like a hot gas
+  if (w.canMoveTo(x, y - 1, Particle::FIRE)) {
+    w.swap(x, y, x, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y - 1);
+    return;
+  }
+
+  // Diagonal rise — randomize direction to avoid left/right bias
+  bool tryLeftFirst = rng.bits(1) == 0;
+  int d1 = tryLeftFirst ? -1 : 1;
+  int d2 = -d1;
+  if (w.canMoveTo(x + d1, y - 1, Particle::FIRE)) {
+    w.swap(x, y, x + d1, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y - 1);
+    return;
+  }
+  if (w.canMoveTo(x + d2, y - 1, Particle::FIRE)) {
+    w.swap(x, y, x + d2, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y - 1);
+    return;
+  }
+
+  // Blocked above — drift sideways
+  if (w.canMoveTo(x + d1, y, Particle::FIRE)) {
+    w.swap(x, y, x + d1, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y);
+  } else if (w.canMoveTo(x + d2, y, Particle::FIRE)) {
+    w.swap(x, y, x + d2, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y);
+  }
+}
+
+// Update steam particle: rises while hot, drifts sideways, condenses to water when cool.
+template <class Wd>
+static void updateSteam(Wd& w, int x, int y, RandomBits& rng) {
+  // Condensation: when the coarse tile has cooled to ambient-ish levels,
+  // steam probabilistically re-condenses into (cool) water.
+  if (tryPhaseChange(w, x, y, Particle::STEAM, rng)) return;
+
+  // Try to rise straight up
+  if (w.canMoveTo(x, y - 1, Particle::STEAM)) {
+    w.swap(x, y, x, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y - 1);
+    return;
+  }
+
+  // Try diagonal rise — randomize which side is preferred
+  bool tryLeftFirst = rng.bits(1) == 0;
+  int d1 = tryLeftFirst ? -1 : 1;
+  int d2 = -d1;
+  if (w.canMoveTo(x + d1, y - 1, Particle::STEAM)) {
+    w.swap(x, y, x + d1, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y - 1);
+    return;
+  }
+  if (w.canMoveTo(x + d2, y - 1, Particle::STEAM)) {
+    w.swap(x, y, x + d2, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y - 1);
+    return;
+  }
+
+  // Blocked above — drift sideways
+  if (w.canMoveTo(x + d1, y, Particle::STEAM)) {
+    w.swap(x, y, x + d1, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y);
+  } else if (w.canMoveTo(x + d2, y, Particle::STEAM)) {
+    w.swap(x, y, x + d2, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y);
+  }
+}
+
+// Update plant particle
+template <class Wd>
+static void updatePlant(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: sustained heat burns plant (range effect via coarse grid)
+  if (tryPhaseChange(w, x, y, Particle::PLANT, rng)) return;
+
+  // Check for lava in adjacent cells - plant burns
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      int nx = x + dx;
+      int ny = y + dy;
+      if (w.at(nx, ny) == Particle::LAVA) {
+        w.setCell(x, y, Particle::AIR);  // Burn plant
+        return;
+      }
+    }
+  }
+  
+  // Check for water in adjacent cells - plant grows
+  bool hasWater = false;
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      int nx = x + dx;
+      int ny = y + dy;
+      if (w.at(nx, ny) == Particle::WATER) {
+        hasWater = true;
+        break;
+      }
+    }
+    if (hasWater) break;
+  }
+  
+  // If touching water, occasionally grow into an adjacent empty space.
+  // All % replaced with & (power-of-2 mask) to avoid software divides on SH4.
+  if (hasWater && rng.chance(PLANT_GROWTH_CHANCE - 1)) {
+    // Pick from the 8 cardinal+diagonal neighbours using a lookup table indexed
+    // by the low 3 bits of the PRNG — no modulo, no dx==dy==0 guard needed.
+    static const int8_t growDx[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+    static const int8_t growDy[8] = { -1, -1, -1, 0, 0,  1, 1, 1 };
+    for (int attempt = 0; attempt < PLANT_GROWTH_ATTEMPTS; attempt++) {
+      int idx = (int)rng.bits(3);
+      int nx = x + growDx[idx];
+      int ny = y + growDy[idx];
+      if (w.at(nx, ny) == Particle::AIR) {
+        w.setCell(nx, ny, Particle::PLANT);
+        break;
+      }
+    }
+  }
+}
+
+// Update a single cell: the per-cell body of the scan, called for every
+// cell not yet updated this tick.  AIR and WALL fall through the switch.
+template <class Wd>
+static inline void updateCell(Wd& w, int x, int y, RandomBits& rng) {
+  Particle p = w.at(x, y);
+  rng.at(x, y);  // counter mode: this cell's draws depend only on (x, y, tick)
+
+  // Check if particle should update based on its density/fall speed.
+  if (!shouldUpdate(p, rng)) return;
+
+  switch (p) {
+    case Particle::SAND:
+      updateSand(w, x, y, rng);
+      break;
+    case Particle::WATER:
+      updateWater(w, x, y, rng);
+      break;
+    case Particle::STONE:
+      updateStone(w, x, y, rng);
+      break;
+    case Particle::LAVA:
+      updateLava(w, x, y, rng);
+      break;
+    case Particle::PLANT:
+      updatePlant(w, x, y, rng);
+      break;
+    case Particle::ICE:
+      updateIce(w, x, y, rng);
+      break;
+    case Particle::STEAM:
+      updateSteam(w, x, y, rng);
+      break;
+    case Particle::ACID:
+      updateAcid(w, x, y, rng);
+      break;
+    case Particle::FIRE:
+      updateFire(w, x, y, rng);
+      break;
+    default:
+      break;
+  }
+}
+
+// Scan grid row y: update every cell not yet updated this tick.  Kernels
+// touch rows y-1..y+1 only.
+template <class Wd>
+static inline void scanRow(Wd& w, int y, RandomBits& rng) {
+  // Alternate scan direction for more natural behavior
+  const bool scanLeft = (y % 2) == 0;
+  for (int k = 0; k < Wd::WIDTH; k++) {
+    const int x = scanLeft ? k : Wd::WIDTH - 1 - k;
+    if (!w.updated[y][x]) updateCell(w, x, y, rng);
+  }
+}
+
+// One physics tick on world 'w'
+template <class Wd>
+static inline void simulateWorld(Wd& w) {
+  // The tick's random bits come from a local pool (see random.h)
+  RandomBits rng = randomBegin();
+
+  memset(w.updated, 0, sizeof(w.updated));
+
+  // Propagate temperature (coarse grid)
+  propagateTemperature(w, rng);
+
+  // Update from bottom to top, alternating left-right order
+  for (int y = Wd::HEIGHT - 2; y >= 0; y--)
+    scanRow(w, y, rng);
+
+  randomEnd(rng);
+}
+
+// Frozen-engine entry points, one per fuzzed temperature scale
+static_assert(TEMP_SCALE == 4, "the fuzzed scales are 1:1, 1:2 and the device's 1:4");
+void referenceSimulate(FuzzReference<1>& w) { simulateWorld(w); }
+void referenceSimulate(FuzzReference<2>& w) { simulateWorld(w); }
+void referenceSimulate(FuzzReference<TEMP_SCALE>& w) { simulateWorld(w); }
@@ -0,0 +1,76 @@
+#ifndef HOST_REFERENCE_H
+#define HOST_REFERENCE_H
+
+#include "config.h"
+#include "particle.h"
+#include "world.h"
+#include <cstring>
+
+// Small world the differential fuzzer runs the optimised engine on: two
+// chunks each way, no UI bar, so random grids stay cheap to step and easy
+// to read.  One per temperature scale the host tools support (1, 2 and the
+// device's TEMP_SCALE, see tempscale.h).
+template <int TempScale>
+using FuzzWorld = World<32, 32, TempScale>;
+
+// The reference engine's own world: the cells inside a WALL sentinel ring,
+// the coarse temperature field, one update flag per cell and the diffusion
+// schedule (passes and hierarchy levels, as World's).  Nothing else is
+// kept — no chunks, occupancy or census — so none of World's bookkeeping
+// is shared with the engine under test.
+template <int W, int H, int TempScale>
+struct ReferenceWorld {
+  static constexpr int WIDTH       = W;
+  static constexpr int HEIGHT      = H;
+  static constexpr int TEMP_SCALE  = TempScale;
+  static constexpr int TEMP_W      = W / TempScale;
+  static constexpr int TEMP_H      = H / TempScale;
+  static constexpr int TEMP_UI_ROW = TEMP_H;  // no UI bar
+
+  Particle cells[H + 2][W + 2];
+  uint8_t temperature[TEMP_H][TEMP_W];
+  bool updated[H][W];
+  uint8_t heatPasses = TEMP_DIFFUSION_PASSES;
+  uint8_t heatLevels = 1;
+
+  Particle &at(int x, int y) { return cells[y + 1][x + 1]; }
+
+  // All AIR inside the WALL ring, ambient temperature; the schedule is kept
+  void clear() {
+    for (int y = -1; y <= H; y++)
+      for (int x = -1; x <= W; x++)
+        at(x, y) = (x < 0 || x >= W || y < 0 || y >= H) ? Particle::WALL : Particle::AIR;
+    memset(temperature, TEMP_AMBIENT, sizeof(temperature));
+    memset(updated, 0, sizeof(updated));
+  }
+
+  // Rule helpers the kernels call (same meaning as World's)
+  bool canMoveTo(int x, int y, Particle type) {
+    return (PARTICLE_DISPLACES[type] >> static_cast<uint8_t>(at(x, y))) & 1u;
+  }
+  void swap(int x1, int y1, int x2, int y2) {
+    const Particle t = at(x1, y1);
+    at(x1, y1) = at(x2, y2);
+    at(x2, y2) = t;
+  }
+  void setCell(int x, int y, Particle p) { at(x, y) = p; }
+  void updatedSet(int x, int y) { updated[y][x] = true; }
+  uint8_t tempGet(int x, int y) const { return temperature[y / TempScale][x / TempScale]; }
+  void tempSet(int x, int y, uint8_t t) { temperature[y / TempScale][x / TempScale] = t; }
+  void pinUiTemperature() {
+    for (int cy = TEMP_UI_ROW; cy < TEMP_H; cy++)
+      for (int cx = 0; cx < TEMP_W; cx++) temperature[cy][cx] = TEMP_AMBIENT;
+  }
+};
+
+template <int TempScale>
+using FuzzReference = ReferenceWorld<32, 32, TempScale>;
+
+// One tick of the frozen reference engine (host/reference.cpp) on 'w'.
+// Draws its randomness through randomBegin()/randomEnd() exactly like
+// simulate().
+void referenceSimulate(FuzzReference<1>& w);
+void referenceSimulate(FuzzReference<2>& w);
+void referenceSimulate(FuzzReference<TEMP_SCALE>& w);
+
+#endif // HOST_REFERENCE_H
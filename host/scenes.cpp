@@ -0,0 +1,97 @@
+#include "scenes.h"
+#include "config.h"
+#include "grid.h"
+#include "particle.h"
+#include "random.h"
+#include <cstring>
+
+// Lowest row a scene may paint: the UI wall sits at GRID_UI_BOUNDARY - 1.
+constexpr int SCENE_FLOOR = GRID_UI_BOUNDARY - 2;
+
+// Fill [x0..x1]×[y0..y1] (inclusive, clipped to the paintable area) with 'p'.
+static void fillRect(int x0, int y0, int x1, int y1, Particle p) {
+  if (y1 > SCENE_FLOOR) y1 = SCENE_FLOOR;
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      if (!isValid(x, y)) continue;
+      setCell(x, y, p);
+      tempSet(x, y, getParticleTemperature(p));
+    }
+  }
+}
+
+// Scene-local scatter stream (never 0, which XorShift32 cannot leave).
+static uint32_t sceneRandom(uint32_t &state) {
+  state = xorshiftStep(state);
+  return state;
+}
+static uint32_t sceneRandomInit(uint32_t seed) {
+  return seed != 0 ? seed ^ 0x5CE7E5u : 0x5CE7E5u;
+}
+
+// A 32-wide block of sand dropped from the top of the screen.
+static void paintSandColumn(uint32_t) {
+  fillRect(64, 0, 95, 79, Particle::SAND);
+}
+
+// A tall body of water against the left wall, free to level out to the right.
+static void paintWaterPool(uint32_t) {
+  fillRect(0, 30, 47, SCENE_FLOOR, Particle::WATER);
+}
+
+// A lava pool and a deeper body of water side by side with nothing between
+// them: steam, stone and fire along the front where they meet.
+static void paintLavaWater(uint32_t) {
+  fillRect(0, 88, 79, SCENE_FLOOR, Particle::LAVA);
+  fillRect(80, 40, GRID_WIDTH - 1, SCENE_FLOOR, Particle::WATER);
+}
+
+// The lower half of the screen packed with plant (about one cell in eight
+// left open), set alight along its whole top edge.
+static void paintPlantFire(uint32_t seed) {
+  uint32_t rng = sceneRandomInit(seed);
+  fillRect(0, 50, GRID_WIDTH - 1, SCENE_FLOOR, Particle::PLANT);
+  for (int y = 50; y <= SCENE_FLOOR; y++)
+    for (int x = 0; x < GRID_WIDTH; x++)
+      if ((sceneRandom(rng) & 7u) == 0) fillRect(x, y, x, y, Particle::AIR);
+  fillRect(0, 48, GRID_WIDTH - 1, 49, Particle::FIRE);
+}
+
+// A full-width acid bath with blocks of sand and stone dropping into it.
+static void paintAcidBath(uint32_t seed) {
+  uint32_t rng = sceneRandomInit(seed);
+  fillRect(0, 80, GRID_WIDTH - 1, SCENE_FLOOR, Particle::ACID);
+  for (int i = 0; i < 12; i++) {
+    const int x = static_cast<int>(sceneRandom(rng) % (GRID_WIDTH - 8));
+    const int y = 8 + static_cast<int>(sceneRandom(rng) % 56);
+    fillRect(x, y, x + 7, y + 7, (i & 1) ? Particle::STONE : Particle::SAND);
+  }
+}
+
+// Sand packed from row 24 to the floor across the whole width: nothing can
+// move, so this measures the cost of a settled, mostly-asleep screen.
+static void paintSettledPile(uint32_t) {
+  fillRect(0, 24, GRID_WIDTH - 1, SCENE_FLOOR, Particle::SAND);
+}
+
+const Scene SCENES[] = {
+  { "sand_column",  "free-falling sand column",          paintSandColumn },
+  { "water_pool",   "levelling water pool",              paintWaterPool },
+  { "lava_water",   "lava meets water reaction zone",    paintLavaWater },
+  { "plant_fire",   "dense plant forest under fire",     paintPlantFire },
+  { "acid_bath",    "acid bath dissolving sand/stone",   paintAcidBath },
+  { "settled_pile", "full-screen settled sand pile",     paintSettledPile },
+};
+const int SCENE_COUNT = static_cast<int>(sizeof(SCENES) / sizeof(SCENES[0]));
+
+const Scene *findScene(const char *name) {
+  for (int i = 0; i < SCENE_COUNT; i++)
+    if (strcmp(SCENES[i].name, name) == 0) return &SCENES[i];
+  return nullptr;
+}
+
+void sceneLoad(const Scene &scene, uint32_t seed) {
+  randomSetMode(randomMode, seed);
+  initGrid();
+  scene.paint(seed);
+}
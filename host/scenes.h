@@ -0,0 +1,32 @@
+#ifndef HOST_SCENES_H
+#define HOST_SCENES_H
+
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Reproducible benchmark scenes for the host tools.
+//
+// sceneLoad() resets the device world (initGrid()), re-seeds the RNG in its
+// current mode and paints the scene straight into the grid with
+// setCell()/tempSet(), each particle at its default temperature.
+// Any scattering inside a scene draws from its own XorShift32 stream seeded
+// from 'seed', so the same (scene, seed) pair always produces the same grid
+// and the same run.
+// ---------------------------------------------------------------------------
+
+struct Scene {
+  const char *name;
+  const char *description;
+  void (*paint)(uint32_t seed);
+};
+
+extern const Scene SCENES[];
+extern const int SCENE_COUNT;
+
+// Scene called 'name', or nullptr.
+const Scene *findScene(const char *name);
+
+// Reset the world and RNG, then paint 'scene' with 'seed'.
+void sceneLoad(const Scene &scene, uint32_t seed);
+
+#endif // HOST_SCENES_H
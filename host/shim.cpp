@@ -0,0 +1,181 @@
+#include "shim.h"
+#include "config.h"
+#include "overclock.h"
+#include <sdk/os/input.h>
+#include <sdk/os/lcd.h>
+#include <sdk/os/mcs.h>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// LCD
+// ---------------------------------------------------------------------------
+static uint16_t vram[SCREEN_WIDTH * SCREEN_HEIGHT];
+static uint32_t refreshCount = 0;
+
+void LCD_GetSize(unsigned int *width, unsigned int *height) {
+  *width  = SCREEN_WIDTH;
+  *height = SCREEN_HEIGHT;
+}
+
+void *LCD_GetVRAMAddress() {
+  return vram;
+}
+
+void LCD_Refresh() {
+  refreshCount++;
+}
+
+uint16_t *hostVram() {
+  return vram;
+}
+
+uint32_t hostRefreshCount() {
+  return refreshCount;
+}
+
+// ---------------------------------------------------------------------------
+// Input
+// ---------------------------------------------------------------------------
+static std::deque<Input_Event> inputQueue;
+
+int GetInput(struct Input_Event *event, uint32_t unknown1, uint32_t unknown2) {
+  (void)unknown1;
+  (void)unknown2;
+  if (inputQueue.empty()) {
+    memset(event, 0, sizeof(*event));
+    event->type = EVENT_NONE;
+    return 0;
+  }
+  *event = inputQueue.front();
+  inputQueue.pop_front();
+  return 0;
+}
+
+void hostPushTouch(int x, int y) {
+  Input_Event e;
+  memset(&e, 0, sizeof(e));
+  e.type = EVENT_TOUCH;
+  e.data.touch_single.direction = KEY_PRESSED;
+  e.data.touch_single.p1_x = x;
+  e.data.touch_single.p1_y = y;
+  inputQueue.push_back(e);
+}
+
+void hostPushKey(uint32_t keyCode, uint32_t direction) {
+  Input_Event e;
+  memset(&e, 0, sizeof(e));
+  e.type = EVENT_KEY;
+  e.data.key.keyCode   = static_cast<Input_Keycode>(keyCode);
+  e.data.key.direction = static_cast<Input_KeyDirection>(direction);
+  inputQueue.push_back(e);
+}
+
+void hostPushActbarEsc() {
+  Input_Event e;
+  memset(&e, 0, sizeof(e));
+  e.type = EVENT_ACTBAR_ESC;
+  inputQueue.push_back(e);
+}
+
+size_t hostPendingInput() {
+  return inputQueue.size();
+}
+
+void hostClearInput() {
+  inputQueue.clear();
+}
+
+// ---------------------------------------------------------------------------
+// MCS
+// ---------------------------------------------------------------------------
+// Variables are keyed by "folder/name".  The returned data pointer stays
+// valid until the variable is overwritten, matching how settings.cpp reads
+// the value immediately after MCS_GetVariable().
+static std::set<std::string> mcsFolders;
+static std::map<std::string, std::vector<uint8_t>> mcsVars;
+
+static std::string mcsKey(const char *folder, const char *name) {
+  return std::string(folder) + "/" + name;
+}
+
+enum MCS_Error MCS_CreateFolder(const char *folder, uint8_t *folderIndex) {
+  (void)folderIndex;
+  return mcsFolders.insert(folder).second ? MCS_OK : MCS_FOLDER_EXISTS;
+}
+
+enum MCS_Error MCS_SetVariable(const char *folder, const char *name,
+                               enum MCS_VariableType type, uint32_t size,
+                               void *data) {
+  (void)type;
+  if (mcsFolders.count(folder) == 0) return MCS_NO_FOLDER;
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  mcsVars[mcsKey(folder, name)].assign(bytes, bytes + size);
+  return MCS_OK;
+}
+
+enum MCS_Error MCS_GetVariable(const char *folder, const char *name,
+                               enum MCS_VariableType *type, char **name2,
+                               void **data, uint32_t *size) {
+  if (mcsFolders.count(folder) == 0) return MCS_NO_FOLDER;
+  auto it = mcsVars.find(mcsKey(folder, name));
+  if (it == mcsVars.end()) return MCS_NO_VARIABLE;
+  *type  = VARTYPE_STR;
+  *name2 = nullptr;
+  *data  = it->second.data();
+  *size  = static_cast<uint32_t>(it->second.size());
+  return MCS_OK;
+}
+
+void hostMcsReset() {
+  mcsFolders.clear();
+  mcsVars.clear();
+}
+
+bool hostMcsFind(const char *folder, const char *name,
+                 const void **data, uint32_t *size) {
+  auto it = mcsVars.find(mcsKey(folder, name));
+  if (it == mcsVars.end()) return false;
+  *data = it->second.data();
+  *size = static_cast<uint32_t>(it->second.size());
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Clock
+// ---------------------------------------------------------------------------
+static const std::chrono::steady_clock::time_point clockEpoch =
+    std::chrono::steady_clock::now();
+
+uint64_t hostNanos() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - clockEpoch).count());
+}
+
+uint32_t hostMicros() {
+  return static_cast<uint32_t>(hostNanos() / 1000u);
+}
+
+// ---------------------------------------------------------------------------
+// Overclock stubs — the CPG/BSC MMIO in overclock.cpp only exists on the
+// SH7305, so the host reports every level as the stock clock.
+// ---------------------------------------------------------------------------
+const char* const overclock_level_names[OC_LEVEL_MAX + 1] = {
+  "DEFAULT", "LIGHT", "MEDIUM", "FAST", "TURBO", "TURBO+",
+};
+
+void oclock_init() {}
+
+void oclock_apply(int level) {
+  (void)level;
+}
+
+int oclock_speed_percent(int level) {
+  (void)level;
+  return 100;
+}
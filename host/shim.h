@@ -0,0 +1,50 @@
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Host-side control surface for the SDK shim layer (make host).
+//
+// The simulation core (grid, physics, renderer, input, settings) is compiled
+// natively with -DHOST_BUILD and links against host/shim.cpp instead of the
+// hollyhock SDK.  The shim provides:
+//   • an in-memory 320×256 RGB565 VRAM behind LCD_GetVRAMAddress()
+//   • a scripted input-event queue behind GetInput()
+//   • an in-memory MCS store behind MCS_CreateFolder/SetVariable/GetVariable
+//   • a monotonic microsecond clock standing in for gettimeofday() on TMU2
+//   • no-op overclock stubs (the CPG/BSC registers only exist on the SH7305)
+//
+// Harnesses use the functions below to drive a run and inspect its output.
+// ---------------------------------------------------------------------------
+
+// --- VRAM ---
+// Direct access to the shim framebuffer (SCREEN_WIDTH × SCREEN_HEIGHT pixels).
+uint16_t *hostVram();
+// Number of LCD_Refresh() calls since start-up.
+uint32_t hostRefreshCount();
+
+// --- Scripted input ---
+// Events are returned by GetInput() in FIFO order.
+void hostPushTouch(int x, int y);
+void hostPushKey(uint32_t keyCode, uint32_t direction);
+void hostPushActbarEsc();
+size_t hostPendingInput();
+void hostClearInput();
+
+// --- MCS store ---
+// Forget every folder and variable.
+void hostMcsReset();
+// Look up a stored variable without going through the SDK-shaped API.
+// Returns false if the folder or variable does not exist.
+bool hostMcsFind(const char *folder, const char *name,
+                 const void **data, uint32_t *size);
+
+// --- Clock ---
+// Monotonic time since the first call, in microseconds (wraps like TMU2 does).
+uint32_t hostMicros();
+// Monotonic time since the first call, in nanoseconds.
+uint64_t hostNanos();
+
+#endif // HOST_SHIM_H
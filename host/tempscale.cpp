@@ -0,0 +1,83 @@
+#include "tempscale.h"
+#include "config.h"
+#include "grid.h"
+#include "physics.h"
+#include "simulation.h"
+#include "world.h"
+
+// Device-sized worlds with a finer temperature field
+template <int S>
+using ScaledWorld = World<GRID_WIDTH, GRID_HEIGHT, S, GRID_UI_BOUNDARY>;
+static_assert(TEMP_SCALE == 4, "the host scales are 1:1, 1:2 and the device's 1:4");
+
+static ScaledWorld<1> world1;
+static ScaledWorld<1>::Storage cells1;
+static ScaledWorld<2> world2;
+static ScaledWorld<2>::Storage cells2;
+static int selected = TEMP_SCALE;
+
+template <class Wd>
+static void loadFromDevice(Wd& w, typename Wd::Storage& cells) {
+  w.attach(cells);
+  w.clear();
+  for (int y = 0; y < GRID_HEIGHT; y++) {
+    for (int x = 0; x < GRID_WIDTH; x++) {
+      const Particle p = world.at(x, y);
+      if (p != w.at(x, y)) w.setCell(x, y, p);
+      w.tempSet(x, y, world.tempGet(x, y));
+    }
+  }
+  const int passes = world.heatPasses * (TEMP_SCALE / Wd::TEMP_SCALE);
+  w.heatPasses = static_cast<uint8_t>(passes < 255 ? passes : 255);
+  w.heatLevels = world.heatLevels;
+}
+
+template <class Wd>
+static int occupiedCells(const Wd& w) {
+  int n = 0;
+  for (int y = 0; y < Wd::HEIGHT; y++)
+    for (int i = 0; i < Wd::WORDS; i++)
+      n += __builtin_popcount(w.occupied[y][i]);
+  return n;
+}
+
+bool tempScaleSupported(int scale) {
+  return scale == 1 || scale == 2 || scale == TEMP_SCALE;
+}
+
+void tempScaleSelect(int scale) {
+  if (tempScaleSupported(scale)) selected = scale;
+}
+
+int tempScaleSelected() {
+  return selected;
+}
+
+void tempScaleLoad() {
+  if (selected == 1)      loadFromDevice(world1, cells1);
+  else if (selected == 2) loadFromDevice(world2, cells2);
+}
+
+void tempScaleSimulate() {
+  if (selected == 1)      simulateWorld(world1);
+  else if (selected == 2) simulateWorld(world2);
+  else                    simulate();
+}
+
+Particle **tempScaleGrid() {
+  if (selected == 1) return world1.grid();
+  if (selected == 2) return world2.grid();
+  return grid;
+}
+
+int tempScaleOccupied() {
+  if (selected == 1) return occupiedCells(world1);
+  if (selected == 2) return occupiedCells(world2);
+  return occupiedCells(world);
+}
+
+int tempScaleAwakeChunks() {
+  if (selected == 1) return world1.awakeChunks;
+  if (selected == 2) return world2.awakeChunks;
+  return awakeChunkCount;
+}
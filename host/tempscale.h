@@ -0,0 +1,41 @@
+#ifndef HOST_TEMPSCALE_H
+#define HOST_TEMPSCALE_H
+
+#include "particle.h"
+
+// ---------------------------------------------------------------------------
+// Host-only temperature resolution.
+//
+// The device world keeps one coarse temperature tile per TEMP_SCALE ×
+// TEMP_SCALE cells to fit its RAM.  The host tools can instead step a copy
+// of it with a finer field: 1:1 (one tile per cell) or 1:2.  The copy is the
+// same World template and the same kernels as the device, instantiated per
+// scale in tempscale.cpp (an -Ofast unit, so diffusion vectorises).
+//
+// tempScaleLoad() copies the device world — cells, temperatures (each tile
+// takes the value of the device tile it lies in) and heat schedule — into
+// the world of the selected scale.  The schedule's pass count is multiplied
+// by TEMP_SCALE / scale, so heat still reaches as many cells per tick; the
+// cost of that is part of what a finer scale costs.  At TEMP_SCALE every
+// call here works on the device world itself.  The copy is never rendered.
+// ---------------------------------------------------------------------------
+
+// True for the scales tempScaleSelect() accepts: 1, 2 and TEMP_SCALE
+bool tempScaleSupported(int scale);
+
+// Pick the world the calls below work on
+void tempScaleSelect(int scale);
+int tempScaleSelected();
+
+// Copy the device world into the selected one (nothing at TEMP_SCALE)
+void tempScaleLoad();
+
+// One physics tick of the selected world (simulate() at TEMP_SCALE)
+void tempScaleSimulate();
+
+// State of the selected world
+Particle **tempScaleGrid();
+int tempScaleOccupied();     // non-air, non-wall cells
+int tempScaleAwakeChunks();  // chunks scanned by the most recent tick
+
+#endif // HOST_TEMPSCALE_H
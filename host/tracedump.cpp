@@ -0,0 +1,118 @@
+// Performance trace decoder: turns the FSandSim/PerfTrc blob written by the
+// 3 key (src/trace.h) into CSV, one row per recorded tick, oldest first.
+//
+//   fsand-tracedump [FILE|-]
+//
+// FILE may be the raw variable contents or any larger dump that contains
+// it (e.g. a main-memory backup): the first trace header found is decoded.
+// Either byte order is accepted — the device writes big-endian, host runs
+// (fsand-headless --trace) little-endian — and the magic says which.
+
+#include "trace.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const char *const PHASE_COLUMNS[PROF_PHASE_COUNT] = {
+  "simulate_us", "temperature_us", "particles_us", "fps_us", "draw_us", "refresh_us", "input_us",
+};
+
+// Byte-order aware field reads from the blob
+struct Reader {
+  const uint8_t *base;
+  bool bigEndian;
+  uint32_t u8(size_t off) const { return base[off]; }
+  uint32_t u16(size_t off) const {
+    return bigEndian ? (base[off] << 8) | base[off + 1]
+                     : (base[off + 1] << 8) | base[off];
+  }
+  uint32_t u32(size_t off) const {
+    return bigEndian ? (u16(off) << 16) | u16(off + 2)
+                     : (u16(off + 2) << 16) | u16(off);
+  }
+};
+
+static bool readAll(const char *path, std::vector<uint8_t> &out) {
+  FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+  if (!f) return false;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+  if (f != stdin) fclose(f);
+  return true;
+}
+
+// Offset of the first trace header in either byte order, or -1
+static long findHeader(const std::vector<uint8_t> &data, bool &bigEndian) {
+  for (size_t i = 0; i + sizeof(TraceHeader) <= data.size(); i++) {
+    const Reader be{ &data[i], true }, le{ &data[i], false };
+    if (be.u32(0) == TRACE_MAGIC) { bigEndian = true;  return static_cast<long>(i); }
+    if (le.u32(0) == TRACE_MAGIC) { bigEndian = false; return static_cast<long>(i); }
+  }
+  return -1;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 2 || (argc == 2 && argv[1][0] == '-' && argv[1][1] != '\0')) {
+    fprintf(stderr, "usage: %s [FILE|-]\n", argv[0]);
+    return 2;
+  }
+  const char *path = argc == 2 ? argv[1] : "-";
+  std::vector<uint8_t> data;
+  if (!readAll(path, data)) {
+    fprintf(stderr, "%s: cannot read '%s'\n", argv[0], path);
+    return 1;
+  }
+
+  bool bigEndian = false;
+  const long at = findHeader(data, bigEndian);
+  if (at < 0) {
+    fprintf(stderr, "%s: no trace header in '%s'\n", argv[0], path);
+    return 1;
+  }
+  const Reader h{ &data[static_cast<size_t>(at)], bigEndian };
+  const uint32_t version    = h.u16(offsetof(TraceHeader, version));
+  const uint32_t recordSize = h.u16(offsetof(TraceHeader, recordSize));
+  const uint32_t recorded   = h.u32(offsetof(TraceHeader, recorded));
+  const uint32_t count      = h.u16(offsetof(TraceHeader, count));
+  const uint32_t first      = h.u16(offsetof(TraceHeader, first));
+  const uint32_t phases     = h.u8(offsetof(TraceHeader, phaseCount));
+  if (version != TRACE_VERSION || recordSize != sizeof(TraceRecord) ||
+      phases != static_cast<uint32_t>(PROF_PHASE_COUNT)) {
+    fprintf(stderr, "%s: unsupported trace (version %u, record %u bytes, %u phases)\n",
+            argv[0], version, recordSize, phases);
+    return 1;
+  }
+  if (count > static_cast<uint32_t>(TRACE_CAPACITY) || (count > 0 && first >= count)) {
+    fprintf(stderr, "%s: corrupt trace header\n", argv[0]);
+    return 1;
+  }
+  const size_t recordsAt = static_cast<size_t>(at) + sizeof(TraceHeader);
+  const size_t available = (data.size() - recordsAt) / recordSize;
+  if (available < count) {
+    fprintf(stderr, "%s: trace truncated (%zu of %u records)\n", argv[0], available, count);
+    return 1;
+  }
+  if (recorded > count)
+    fprintf(stderr, "%s: ring wrapped; %u earliest ticks were overwritten\n",
+            argv[0], recorded - count);
+
+  printf("tick");
+  for (int p = 0; p < PROF_PHASE_COUNT; p++) printf(",%s", PHASE_COLUMNS[p]);
+  printf(",active_cells,dirty_cells,awake_chunks,overclock_level,sim_speed_mode,rendered\n");
+  for (uint32_t i = 0; i < count; i++) {
+    const uint32_t slot = (first + i) % count;
+    const Reader r{ &data[recordsAt + slot * recordSize], bigEndian };
+    printf("%u", r.u32(offsetof(TraceRecord, tick)));
+    for (int p = 0; p < PROF_PHASE_COUNT; p++)
+      printf(",%u", r.u16(offsetof(TraceRecord, phaseUs) + 2 * static_cast<size_t>(p)));
+    printf(",%u,%u,%u,%u,%u,%u\n",
+           r.u16(offsetof(TraceRecord, activeCells)),
+           r.u16(offsetof(TraceRecord, dirtyCells)),
+           r.u8(offsetof(TraceRecord, awakeChunks)),
+           r.u8(offsetof(TraceRecord, overclockLevel)),
+           r.u8(offsetof(TraceRecord, simSpeedMode)),
+           r.u8(offsetof(TraceRecord, flags)) & TRACE_FLAG_RENDERED ? 1u : 0u);
+  }
+  return 0;
+}
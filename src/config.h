@@ -77,6 +77,19 @@ extern const char* const simSpeedModeNames[SIM_SPEED_MODE_MAX + 1];
 // Map mode → number of frames skipped between each render (0 = no skip)
 extern const int simSkipAmounts[SIM_SPEED_MODE_MAX + 1];
 
+// Heat propagation mode — runtime variable persisted via MCS (see settings.h).
+// Each mode trades blend passes over the coarse temperature field for levels
+// of the heat hierarchy (see propagateTemperature()): mode 0 runs the plain
+// TEMP_DIFFUSION_PASSES passes, higher modes fewer passes plus blends on
+// 2×2- and 4×4-tile averages that carry heat further per tick.
+constexpr int HEAT_MODE_DEFAULT = 0;
+constexpr int HEAT_MODE_MAX     = 2;
+// Names shown in the settings screen
+extern const char* const heatModeNames[HEAT_MODE_MAX + 1];
+// Map mode → blend passes on the field / hierarchy levels (1 = field only)
+extern const int heatModePasses[HEAT_MODE_MAX + 1];
+extern const int heatModeLevels[HEAT_MODE_MAX + 1];
+
 // Simulation probabilities and limits
 constexpr int LAVA_FLOW_CHANCE = 4;        // 1 in 4 chance to flow sideways (power-of-2 → bitwise AND replaces % on SH4)
 constexpr int PLANT_GROWTH_CHANCE = 8;     // 1 in 8 chance to grow per frame  (power-of-2 → bitwise AND replaces % on SH4)
@@ -142,18 +155,45 @@ constexpr int TEMP_SCALE   = 4;
 constexpr int TEMP_GRID_W  = GRID_WIDTH  / TEMP_SCALE;  // 48
 constexpr int TEMP_GRID_H  = GRID_HEIGHT / TEMP_SCALE;  // 24
 
+// Sleep/wake chunks: simulate() only scans the dirty rectangle of each awake
+// CHUNK_SIZE×CHUNK_SIZE chunk (see grid.h).  Must divide both grid dimensions
+// and stay <= 256 so chunk-local rectangle bounds fit in a uint8_t.
+constexpr int CHUNK_SIZE = 16;
+constexpr int CHUNK_COLS = GRID_WIDTH  / CHUNK_SIZE;  // 10
+constexpr int CHUNK_ROWS = GRID_HEIGHT / CHUNK_SIZE;  // 8
+static_assert(GRID_WIDTH % CHUNK_SIZE == 0 && GRID_HEIGHT % CHUNK_SIZE == 0,
+              "CHUNK_SIZE must divide the grid dimensions");
+static_assert(CHUNK_SIZE % TEMP_SCALE == 0, "chunks must cover whole coarse tiles");
+
 // Grid row split across on-chip X/Y RAM (4 KB per bank, 2 banks each = 8 KB each)
-// X RAM holds rows 0..41  (42 × 160 = 6,720 bytes < 8,192)
-// Y RAM holds rows 42..83 (42 × 160 = 6,720 bytes < 8,192)
-// Regular RAM holds rows 84..127 (44 × 160 = 7,040 bytes)
+// Every stored row carries a one-cell WALL sentinel on each side
+// (GRID_STRIDE = 162 bytes), and a full sentinel row sits above row 0 and
+// below row 127, so kernels can probe any neighbour without bounds checks.
+// X RAM holds the top sentinel + rows 0..41  (43 × 162 = 6,966 bytes < 8,192)
+// Y RAM holds rows 42..83 (42 × 162 = 6,804 bytes + property table < 8,192)
+// Regular RAM holds rows 84..127 + the bottom sentinel (45 × 162 = 7,290 bytes)
+constexpr int GRID_STRIDE    = GRID_WIDTH + 2;
 constexpr int GRID_ROWS_X    = 42;
 constexpr int GRID_ROWS_Y    = 42;
-constexpr int GRID_ROWS_REST = GRID_HEIGHT - GRID_ROWS_X - GRID_ROWS_Y; // 12
+constexpr int GRID_ROWS_REST = GRID_HEIGHT - GRID_ROWS_X - GRID_ROWS_Y; // 44
+constexpr int OC_MEM_BANK_BYTES = 8192;
 
 // ILRAM placement: functions marked with this attribute are placed in the
 // SH7305's internal instruction RAM, which is significantly faster to fetch
 // and execute than regular external flash/SDRAM.
-#define ILRAM_FUNC __attribute__((section(".ilram")))
+// OC_MEM_X_DATA / OC_MEM_Y_DATA place data in on-chip X/Y RAM; section names
+// match the SDK linker script (same as CPBoy).
+// The headless host build (make host, -DHOST_BUILD) has no on-chip memories,
+// so all three compile away and everything lands in ordinary RAM.
+#ifdef HOST_BUILD
+#define ILRAM_FUNC
+#define OC_MEM_X_DATA
+#define OC_MEM_Y_DATA
+#else
+#define ILRAM_FUNC    __attribute__((section(".ilram")))
+#define OC_MEM_X_DATA __attribute__((section(".oc_mem.x.data")))
+#define OC_MEM_Y_DATA __attribute__((section(".oc_mem.y.data")))
+#endif
 
 // Temperature constants (0-255 scale)
 constexpr uint8_t TEMP_AMBIENT = 50;      // Default/room temperature
@@ -185,6 +225,25 @@ constexpr uint8_t TEMP_STONE_MELT    = 230;
 // Higher = faster, more visible spread; lower = cheaper.
 constexpr int TEMP_DIFFUSION_PASSES = 4;
 
+// Thermal sub-cycling (see temperatureTick() in simulation.h): while few
+// coarse tiles lie outside the thermally neutral band, the source pass runs
+// only every few ticks and injects for all of them at once.  Diffusion runs
+// every tick.
+// The step covers TEMP_SUBCYCLE_MAX ticks with fewer than
+// tiles >> TEMP_SUBCYCLE_QUIET_SHIFT such tiles, 2 ticks with up to
+// tiles >> TEMP_SUBCYCLE_BUSY_SHIFT, and a single tick above that.
+constexpr int TEMP_SUBCYCLE_MAX         = 4;  // must be a power of 2
+constexpr int TEMP_SUBCYCLE_QUIET_SHIFT = 6;
+constexpr int TEMP_SUBCYCLE_BUSY_SHIFT  = 4;
+static_assert(TEMP_SUBCYCLE_MAX >= 2 && (TEMP_SUBCYCLE_MAX & (TEMP_SUBCYCLE_MAX - 1)) == 0,
+              "TEMP_SUBCYCLE_MAX must be a power of 2");
+static_assert(TEMP_BURIED_COOL_MASK + 1 > TEMP_SUBCYCLE_MAX,
+              "a step's buried-cooling chance must stay below 1");
+
+// Deepest heat hierarchy (see heatModeLevels): the field plus 2×2- and
+// 4×4-tile levels, so the coarse grid must divide by 4 both ways.
+constexpr int TEMP_HEAT_LEVELS_MAX = 3;
+
 // First coarse row that lies entirely within the UI bar.
 // Coarse tiles at cy >= this value are always pinned to TEMP_AMBIENT so heat
 // cannot bleed behind the particle-selector UI at the bottom of the screen.
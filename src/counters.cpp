@@ -0,0 +1,49 @@
+#include "counters.h"
+
+const char* const PHYS_COUNTER_NAMES[PHYS_COUNTER_COUNT] = {
+  "UPD", "SKIP", "MOVE", "PROBE", "RNG",
+  "COLD", "HOT", "SOLID", "SCORCH", "QUENCH", "MELT", "BURN", "SPARK",
+  "DISSOLVE", "CONSUMED", "BURNOUT", "IGNITE", "GROW",
+};
+
+const char* const PHYS_TYPE_NAMES[PARTICLE_TYPE_COUNT] = {
+  "TEMP", "SAND", "WATER", "STONE", "WALL", "LAVA",
+  "PLANT", "ICE", "STEAM", "ACID", "FIRE",
+};
+
+#ifdef PHYSICS_COUNTERS
+uint8_t  physCountType = 0;
+uint32_t physCountersTick[PARTICLE_TYPE_COUNT][PHYS_COUNTER_COUNT];
+uint32_t physCountersLast[PARTICLE_TYPE_COUNT][PHYS_COUNTER_COUNT];
+uint64_t physCountersTotal[PARTICLE_TYPE_COUNT][PHYS_COUNTER_COUNT];
+uint32_t physCountersTicks = 0;
+
+void physCountersReset() {
+  for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+    for (int c = 0; c < PHYS_COUNTER_COUNT; c++) {
+      physCountersTick[t][c]  = 0;
+      physCountersLast[t][c]  = 0;
+      physCountersTotal[t][c] = 0;
+    }
+  }
+  physCountersTicks = 0;
+}
+
+void physCountersBeginTick() {
+  for (int t = 0; t < PARTICLE_TYPE_COUNT; t++)
+    for (int c = 0; c < PHYS_COUNTER_COUNT; c++)
+      physCountersTick[t][c] = 0;
+  physCountType = static_cast<uint8_t>(Particle::AIR);
+}
+
+// Publish the finished tick's counts and add them to the running totals
+void physCountersEndTick() {
+  for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+    for (int c = 0; c < PHYS_COUNTER_COUNT; c++) {
+      physCountersLast[t][c]   = physCountersTick[t][c];
+      physCountersTotal[t][c] += physCountersTick[t][c];
+    }
+  }
+  physCountersTicks++;
+}
+#endif
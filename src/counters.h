@@ -0,0 +1,91 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <cstdint>
+#include "config.h"
+
+// Hot-path event counters, per particle type per tick.
+//
+// Only built with PHYSICS_COUNTERS defined (make COUNTERS=1, which also
+// moves the objects to their own build directory).  Otherwise every
+// physCount*() below is an empty inline function and the storage does not
+// exist, so normal builds carry no trace of them.
+//
+// Events are charged to the type of the cell being updated (updateCell()
+// sets it).  Work done outside the particle scan — the temperature pass's
+// random draws — lands in the AIR row, which never updates itself, so
+// reports label that row "TEMP".
+
+enum class PhysCounter : uint8_t {
+  UPDATES,    // updateCell() calls
+  SKIPPED,    //   of which shouldUpdate() sat out
+  MOVES,      // swaps
+  PROBES,     // neighbour reads: canMoveTo() and reaction scans
+  RANDOM,     // RandomBits::bits() draws
+  // Reactions
+  PHASE_COLD, // table-driven cold conversion (freeze, condense)
+  PHASE_HOT,  // table-driven hot conversion (melt, evaporate, scorch, burn)
+  SOLIDIFY,   // isolated lava -> stone
+  SCORCH,     // lava: neighbouring sand -> stone
+  QUENCH,     // water -> steam by lava, fire + water -> steam
+  MELT,       // lava: neighbouring ice -> water
+  BURN,       // plant destroyed by lava contact
+  SPARK,      // lava emits fire above
+  DISSOLVE,   // acid dissolves a neighbour
+  CONSUMED,   // acid used up by a reaction
+  BURNOUT,    // fire burns out
+  IGNITE,     // fire spreads to a plant
+  GROW,       // plant grows into air
+  COUNT
+};
+constexpr int PHYS_COUNTER_COUNT = static_cast<int>(PhysCounter::COUNT);
+// First reaction counter; reports sum PHASE_COLD..GROW as "reactions"
+constexpr int PHYS_REACTION_FIRST = static_cast<int>(PhysCounter::PHASE_COLD);
+
+// Short upper-case names (debug screen font has no lower case), in enum order
+extern const char* const PHYS_COUNTER_NAMES[PHYS_COUNTER_COUNT];
+// Row labels, indexed by Particle ("TEMP" for the AIR row)
+extern const char* const PHYS_TYPE_NAMES[PARTICLE_TYPE_COUNT];
+
+#ifdef PHYSICS_COUNTERS
+// Type the next events are charged to
+extern uint8_t physCountType;
+// Counts of the tick in progress, of the last finished tick, and since
+// physCountersReset()
+extern uint32_t physCountersTick[PARTICLE_TYPE_COUNT][PHYS_COUNTER_COUNT];
+extern uint32_t physCountersLast[PARTICLE_TYPE_COUNT][PHYS_COUNTER_COUNT];
+extern uint64_t physCountersTotal[PARTICLE_TYPE_COUNT][PHYS_COUNTER_COUNT];
+extern uint32_t physCountersTicks;
+
+// Clear everything (counts and tick total)
+void physCountersReset();
+// Tick bracket called by simulateWorld(): clear the in-progress counts and
+// charge to the TEMP row; then publish them as 'last' and add to 'total'
+void physCountersBeginTick();
+void physCountersEndTick();
+#endif
+
+constexpr bool PHYSICS_COUNTERS_ENABLED =
+#ifdef PHYSICS_COUNTERS
+    true;
+#else
+    false;
+#endif
+
+inline void physCount(PhysCounter c) {
+#ifdef PHYSICS_COUNTERS
+  physCountersTick[physCountType][static_cast<int>(c)]++;
+#else
+  (void)c;
+#endif
+}
+
+inline void physCountFor(Particle p) {
+#ifdef PHYSICS_COUNTERS
+  physCountType = static_cast<uint8_t>(p);
+#else
+  (void)p;
+#endif
+}
+
+#endif // COUNTERS_H
@@ -0,0 +1,109 @@
+#include "frametime.h"
+#include "profiler.h"
+
+// Per-clock state
+struct FrameClockState {
+  uint32_t histogram[FT_BUCKETS];
+  uint64_t sumUs;
+  uint32_t count;
+  uint32_t worstUs;
+  uint32_t ring[FPS_SAMPLE_COUNT];  // last intervals for the rate
+  uint32_t ringTotal;               // sum of ring[]
+  uint8_t  ringNext;
+  bool     started;                 // lastUs holds a real stamp
+  uint32_t lastUs;
+};
+
+static FrameClockState clocks[FRAME_CLOCK_COUNT];
+
+// Histogram bucket of a 'us' interval (see frametime.h)
+static int bucketOf(uint32_t us) {
+  if (us < static_cast<uint32_t>(FT_SUB_BUCKETS)) return static_cast<int>(us);
+  const int msb = 31 - __builtin_clz(us);
+  if (msb >= FT_MAX_LOG2) return FT_BUCKETS - 1;
+  const int sub = static_cast<int>(us >> (msb - FT_SUB_BITS)) & (FT_SUB_BUCKETS - 1);
+  return (msb - FT_SUB_BITS + 1) * FT_SUB_BUCKETS + sub;
+}
+
+// Largest interval that falls into bucket 'b'
+static uint32_t bucketUpper(int b) {
+  if (b < FT_SUB_BUCKETS) return static_cast<uint32_t>(b);
+  const int shift = b / FT_SUB_BUCKETS - 1;  // msb - FT_SUB_BITS
+  const uint32_t lower = static_cast<uint32_t>(FT_SUB_BUCKETS + b % FT_SUB_BUCKETS) << shift;
+  return lower + (1u << shift) - 1u;
+}
+
+void frameTimeReset() {
+  for (int c = 0; c < FRAME_CLOCK_COUNT; c++) {
+    FrameClockState& s = clocks[c];
+    for (int b = 0; b < FT_BUCKETS; b++) s.histogram[b] = 0;
+    s.sumUs   = 0;
+    s.count   = 0;
+    s.worstUs = 0;
+    // Assume 60 FPS (~16667 µs) until real samples replace the ring
+    for (int i = 0; i < FPS_SAMPLE_COUNT; i++) s.ring[i] = 1000000u / 60u;
+    s.ringTotal = (1000000u / 60u) * FPS_SAMPLE_COUNT;
+    s.ringNext  = 0;
+    s.started   = false;
+    s.lastUs    = 0;
+  }
+}
+
+void frameTimeRecord(FrameClock clock, uint32_t us) {
+  FrameClockState& s = clocks[static_cast<int>(clock)];
+  s.histogram[bucketOf(us)]++;
+  s.sumUs += us;
+  s.count++;
+  if (us > s.worstUs) s.worstUs = us;
+
+  // Running total instead of re-summing the ring on every call; clamped so
+  // FPS_SAMPLE_COUNT entries cannot overflow it
+  const uint32_t r = us < FT_MAX_US ? us : FT_MAX_US;
+  s.ringTotal += r - s.ring[s.ringNext];
+  s.ring[s.ringNext] = r;
+  s.ringNext = static_cast<uint8_t>(s.ringNext + 1 == FPS_SAMPLE_COUNT ? 0 : s.ringNext + 1);
+}
+
+void frameTimeMark(FrameClock clock) {
+  FrameClockState& s = clocks[static_cast<int>(clock)];
+  const uint32_t now = getMicros();
+  if (s.started) {
+    uint32_t delta = now - s.lastUs;
+    // Guard against zero delta (back-to-back calls within the same microsecond)
+    if (delta == 0u) delta = 1u;
+    frameTimeRecord(clock, delta);
+  }
+  s.started = true;
+  s.lastUs  = now;
+}
+
+// Upper edge of the bucket holding the nearest-rank 'pct' percentile
+static uint32_t percentile(const FrameClockState& s, uint32_t pct) {
+  const uint32_t rank = static_cast<uint32_t>(
+      (static_cast<uint64_t>(s.count) * pct + 99u) / 100u);
+  uint32_t seen = 0;
+  for (int b = 0; b < FT_BUCKETS; b++) {
+    seen += s.histogram[b];
+    if (seen >= rank) {
+      // The last bucket also takes everything past FT_MAX_US
+      if (b == FT_BUCKETS - 1) return s.worstUs;
+      const uint32_t upper = bucketUpper(b);
+      return upper < s.worstUs ? upper : s.worstUs;
+    }
+  }
+  return s.worstUs;
+}
+
+FrameTimeStats frameTimeStats(FrameClock clock) {
+  const FrameClockState& s = clocks[static_cast<int>(clock)];
+  if (s.count == 0) return { 0, 0, 0, 0, 0, 0 };
+  return { s.count, static_cast<uint32_t>(s.sumUs / s.count),
+           percentile(s, 50), percentile(s, 95), percentile(s, 99), s.worstUs };
+}
+
+uint32_t frameTimeRate(FrameClock clock) {
+  const FrameClockState& s = clocks[static_cast<int>(clock)];
+  if (s.ringTotal == 0) return 0;
+  // (samples × 1,000,000 µs/s) / total_µs, rounded
+  return (FPS_SAMPLE_COUNT * 1000000u + s.ringTotal / 2u) / s.ringTotal;
+}
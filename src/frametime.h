@@ -0,0 +1,62 @@
+#ifndef FRAMETIME_H
+#define FRAMETIME_H
+
+#include <cstdint>
+#include "config.h"
+
+// Integer-only frame-time statistics.
+//
+// Two clocks are kept: one sample per physics tick (updateFPS()) and one per
+// rendered frame (after LCD_Refresh()).  Each clock has
+//  - a ring of its last FPS_SAMPLE_COUNT intervals with a running total,
+//    so the FPS counter is one integer divide and only when it is drawn;
+//  - a log-bucketed histogram of every interval since frameTimeReset(),
+//    from which mean / p50 / p95 / p99 / worst are read.
+// Nothing here uses floating point: the SH4A build has no FPU, and every
+// float operation would be a soft-float library call.
+//
+// Histogram buckets: values below FT_SUB_BUCKETS µs have one bucket each;
+// above that every power of two is split into FT_SUB_BUCKETS equal steps,
+// so a percentile is exact to within 1/FT_SUB_BUCKETS (12.5%) of its value.
+// Intervals of FT_MAX_US or more share the last bucket (worst stays exact).
+
+enum class FrameClock : uint8_t {
+  TICK,    // between successive physics ticks
+  RENDER,  // between successive rendered frames
+  COUNT
+};
+constexpr int FRAME_CLOCK_COUNT = static_cast<int>(FrameClock::COUNT);
+
+constexpr int FT_SUB_BITS    = 3;
+constexpr int FT_SUB_BUCKETS = 1 << FT_SUB_BITS;
+constexpr int FT_MAX_LOG2    = 24;                // ~16.8 s
+constexpr uint32_t FT_MAX_US = 1u << FT_MAX_LOG2;
+constexpr int FT_BUCKETS     = (FT_MAX_LOG2 - FT_SUB_BITS + 1) * FT_SUB_BUCKETS;
+
+struct FrameTimeStats {
+  uint32_t count;   // intervals since frameTimeReset()
+  uint32_t meanUs;
+  uint32_t p50Us;   // percentiles: upper edge of the bucket holding the
+  uint32_t p95Us;   // nearest-rank sample, capped at worstUs
+  uint32_t p99Us;
+  uint32_t worstUs;
+};
+
+// Clear both clocks: histograms, rings (primed to 60 FPS) and last stamps.
+// The first frameTimeMark() after a reset only starts the interval.
+void frameTimeReset();
+
+// Close the current interval of 'clock' at the current time
+void frameTimeMark(FrameClock clock);
+
+// Add one interval of 'us' microseconds to 'clock' (for callers that time
+// the work themselves, e.g. benchmarks)
+void frameTimeRecord(FrameClock clock, uint32_t us);
+
+// Summary of every interval recorded since the last reset
+FrameTimeStats frameTimeStats(FrameClock clock);
+
+// Rate over the last FPS_SAMPLE_COUNT intervals, rounded to an integer
+uint32_t frameTimeRate(FrameClock clock);
+
+#endif // FRAMETIME_H
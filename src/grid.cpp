@@ -1,72 +1,30 @@
 #include "grid.h"
 #include "config.h"
-#include <cstring>
 
-// Grid split across on-chip X/Y RAM — section names match the SDK linker script (same as CPBoy)
-Particle gridX[GRID_ROWS_X][GRID_WIDTH]       __attribute__((section(".oc_mem.x.data")));
-Particle gridY[GRID_ROWS_Y][GRID_WIDTH]       __attribute__((section(".oc_mem.y.data")));
-Particle gridRest[GRID_ROWS_REST][GRID_WIDTH]; // remaining rows in regular RAM
-// Row-pointer table (built in initGrid)
-Particle *grid[GRID_HEIGHT];
-alignas(32) uint32_t updated[GRID_HEIGHT][UPDATED_WORDS]; // Bitset: 1 bit per cell
-alignas(32) uint8_t temperature[TEMP_GRID_H][TEMP_GRID_W]; // Coarse temperature grid (1,152 bytes)
-alignas(32) uint32_t dirty[GRID_HEIGHT][UPDATED_WORDS];    // Render dirty bitset (2,560 bytes)
+// Grid split across on-chip X/Y RAM (see OC_MEM_X_DATA / OC_MEM_Y_DATA in config.h)
+Particle gridX[GRID_ROWS_X + 1][GRID_STRIDE]       OC_MEM_X_DATA; // + top sentinel row
+Particle gridY[GRID_ROWS_Y][GRID_STRIDE]           OC_MEM_Y_DATA;
+Particle gridRest[GRID_ROWS_REST + 1][GRID_STRIDE]; // remaining rows + bottom sentinel row
+
+static_assert(sizeof(gridX) <= OC_MEM_BANK_BYTES, "gridX exceeds X RAM");
+static_assert(sizeof(gridY) + sizeof(ParticleTable) <= OC_MEM_BANK_BYTES,
+              "gridY and the property table exceed Y RAM");
+
+// Row table, bitsets (2,560 bytes each), coarse temperature (1,280 bytes),
+// its material census (5,120 bytes) and sleep/wake chunks (640 bytes)
+DeviceWorld world;
 
 // Initialize the grid
 void initGrid() {
-  // Build row-pointer table
-  for (int y = 0; y < GRID_ROWS_X; y++)
-    grid[y] = gridX[y];
+  // Build row-pointer table, skipping each row's left sentinel
+  for (int y = 0; y < GRID_ROWS_X + 1; y++)
+    world.rows[y] = &gridX[y][1];
   for (int y = 0; y < GRID_ROWS_Y; y++)
-    grid[GRID_ROWS_X + y] = gridY[y];
-  for (int y = 0; y < GRID_ROWS_REST; y++)
-    grid[GRID_ROWS_X + GRID_ROWS_Y + y] = gridRest[y];
-
-  memset(updated, 0, sizeof(updated));
-  memset(dirty, 0xFF, sizeof(dirty)); // force full repaint after clear
-  memset(temperature, TEMP_AMBIENT, sizeof(temperature));
-  for (int y = 0; y < GRID_HEIGHT; y++) {
-    for (int x = 0; x < GRID_WIDTH; x++) {
-      grid[y][x] = Particle::AIR;
-    }
-  }
-
-  // Create bottom wall
-  for (int x = 0; x < GRID_WIDTH; x++) {
-    grid[GRID_UI_BOUNDARY - 1][x] = Particle::WALL;
-  }
-
-}
-
-// Check if coordinates are valid
-bool isValid(int x, int y) {
-  return x >= 0 && x < GRID_WIDTH && y >= 0 && y < GRID_HEIGHT;
-}
-
-// Check if a cell is empty (air)
-bool isEmpty(int x, int y) {
-  return isValid(x, y) && grid[y][x] == Particle::AIR;
-}
-
-// Check if a particle can move to a position
-bool canMoveTo(int x, int y, Particle type) {
-  if (!isValid(x, y)) return false;
-  if (y >= GRID_UI_BOUNDARY) return false;
-  
-  Particle target = grid[y][x];
-  
-  // Air can always be moved into
-  if (target == Particle::AIR) return true;
-  
-  // Sand and Ice can displace water
-  if ((type == Particle::SAND || type == Particle::ICE) && target == Particle::WATER) return true;
-  
-  return false;
-}
+    world.rows[GRID_ROWS_X + 1 + y] = &gridY[y][1];
+  for (int y = 0; y < GRID_ROWS_REST + 1; y++)
+    world.rows[GRID_ROWS_X + GRID_ROWS_Y + 1 + y] = &gridRest[y][1];
 
-// Swap two particles
-void swap(int x1, int y1, int x2, int y2) {
-  Particle temp = grid[y1][x1];
-  grid[y1][x1] = grid[y2][x2];
-  grid[y2][x2] = temp;
+  // Sentinels, AIR interior, the wall row above the UI bar, ambient
+  // temperature and every chunk awake
+  world.clear();
 }
@@ -2,61 +2,51 @@
 #define GRID_H
 
 #include "config.h"
+#include "particle.h"
+#include "world.h"
+
+// The device world: GRID_WIDTH×GRID_HEIGHT cells, one coarse temperature
+// tile per TEMP_SCALE×TEMP_SCALE block, UI bar from GRID_UI_BOUNDARY down.
+using DeviceWorld = World<GRID_WIDTH, GRID_HEIGHT, TEMP_SCALE, GRID_UI_BOUNDARY>;
+static_assert(DeviceWorld::STRIDE == GRID_STRIDE && DeviceWorld::TEMP_W == TEMP_GRID_W &&
+              DeviceWorld::TEMP_H == TEMP_GRID_H && DeviceWorld::TEMP_UI_ROW == TEMP_UI_COARSE_ROW &&
+              DeviceWorld::CHUNK_COLS == CHUNK_COLS && DeviceWorld::CHUNK_ROWS == CHUNK_ROWS,
+              "DeviceWorld disagrees with config.h");
+extern DeviceWorld world;
 
 // Words per row for the updated bitset
-constexpr int UPDATED_WORDS = (GRID_WIDTH + 31) / 32;
-
-// Global grid split across on-chip X/Y RAM (rows 0-41 in X, 42-83 in Y, 84-127 in RAM)
-// Sub-arrays (do not access directly; use grid[y][x])
-extern Particle gridX[GRID_ROWS_X][GRID_WIDTH];    // .oc_mem.x.data
-extern Particle gridY[GRID_ROWS_Y][GRID_WIDTH];    // .oc_mem.y.data
-extern Particle gridRest[GRID_ROWS_REST][GRID_WIDTH]; // regular RAM
-// Row-pointer table — grid[y][x] works identically to a 2-D array
-extern Particle *grid[GRID_HEIGHT];
-extern uint32_t updated[GRID_HEIGHT][UPDATED_WORDS]; // Bitset: 1 bit per cell (576 bytes vs 18 KB)
-extern uint8_t temperature[TEMP_GRID_H][TEMP_GRID_W]; // Coarse temperature grid (1,152 bytes vs 18 KB)
-// Dirty bitset: OR-accumulates updated flags across simulate() calls between renders.
-// drawGrid() uses this to skip unchanged cells, then clears it after each rendered frame.
-// initGrid() sets all bits so the very first drawGrid() paints everything.
-extern uint32_t dirty[GRID_HEIGHT][UPDATED_WORDS];
-
-// Coarse temperature accessors (fine-cell coordinates)
-inline uint8_t tempGet(int x, int y) {
-  return temperature[y / TEMP_SCALE][x / TEMP_SCALE];
-}
-inline void tempSet(int x, int y, uint8_t val) {
-  temperature[y / TEMP_SCALE][x / TEMP_SCALE] = val;
-}
-
-// Bitset helpers
-inline bool updatedGet(int x, int y) {
-  return (updated[y][x >> 5] >> (x & 31)) & 1u;
-}
-inline void updatedSet(int x, int y) {
-  updated[y][x >> 5] |= (1u << (x & 31));
-}
-
-// Dirty-bitset helpers (render-side dirty tracking)
-inline bool dirtyGet(int x, int y) {
-  return (dirty[y][x >> 5] >> (x & 31)) & 1u;
-}
-inline void dirtySet(int x, int y) {
-  dirty[y][x >> 5] |= (1u << (x & 31));
-}
+constexpr int UPDATED_WORDS = DeviceWorld::WORDS;
+
+// Device grid cells split across on-chip X/Y RAM (rows 0-41 in X, 42-83 in
+// Y, 84-127 in RAM).  Sub-arrays (do not access directly; use grid[y][x]).
+// Each stored row is GRID_STRIDE wide with a WALL sentinel at both ends;
+// gridX starts with and gridRest ends with a full WALL sentinel row.
+extern Particle gridX[GRID_ROWS_X + 1][GRID_STRIDE];       // .oc_mem.x.data
+extern Particle gridY[GRID_ROWS_Y][GRID_STRIDE];           // .oc_mem.y.data
+extern Particle gridRest[GRID_ROWS_REST + 1][GRID_STRIDE]; // regular RAM
+// grid[y][x] works identically to a 2-D array for 0 <= x < GRID_WIDTH,
+// 0 <= y < GRID_HEIGHT, and reads WALL for x or y one step outside that.
+// The sentinels are never written: nothing displaces or converts WALL.
+constexpr Particle **grid = &world.rows[1];
+
+// The device world's bitsets and fields under their global names
+// (see World for what each one holds).
+inline constexpr auto& updated     = world.updated;
+inline constexpr auto& dirty       = world.dirty;
+inline constexpr auto& occupied    = world.occupied;
+inline constexpr auto& temperature = world.temperature;
+inline constexpr auto& chunks      = world.chunks;
+
+// Device-world wrappers for renderer and input code
+inline uint8_t tempGet(int x, int y) { return world.tempGet(x, y); }
+inline void tempSet(int x, int y, uint8_t val) { world.tempSet(x, y, val); }
+inline bool dirtyGet(int x, int y) { return world.dirtyGet(x, y); }
+inline void dirtySet(int x, int y) { world.dirtySet(x, y); }
+inline void setCell(int x, int y, Particle p) { world.setCell(x, y, p); }
+inline bool isValid(int x, int y) { return DeviceWorld::isValid(x, y); }
+inline bool isEmpty(int x, int y) { return world.isEmpty(x, y); }
 
 // Initialize the grid
 void initGrid();
 
-// Check if coordinates are valid
-bool isValid(int x, int y);
-
-// Check if a cell is empty (air)
-bool isEmpty(int x, int y);
-
-// Check if a particle can move to a position
-bool canMoveTo(int x, int y, Particle type);
-
-// Swap two particles
-void swap(int x1, int y1, int x2, int y2);
-
 #endif // GRID_H
@@ -3,8 +3,10 @@
 #include "grid.h"
 #include "particle.h"
 #include "overclock.h"
+#include "profiler.h"
 #include "renderer.h"
 #include "settings.h"
+#include "trace.h"
 #include <cstring>
 #include <sdk/os/input.h>
 
@@ -16,6 +18,7 @@ int brushSize = BRUSH_SIZE_DEFAULT;
 
 // Temperature heat-map overlay toggle
 bool tempViewEnabled = false;
+bool countersViewEnabled = false;
 
 // Place particles at position
 static void placeParticle(int gridX, int gridY) {
@@ -33,7 +36,7 @@ static void placeParticle(int gridX, int gridY) {
         if (isValid(x, y) && y < GRID_UI_BOUNDARY) {
           // Don't erase the UI boundary wall at row GRID_UI_BOUNDARY-1
           if (y == GRID_UI_BOUNDARY - 1) continue;
-          grid[y][x] = Particle::AIR;
+          setCell(x, y, Particle::AIR);
           tempSet(x, y, TEMP_AMBIENT);
           dirtySet(x, y);
         }
@@ -52,7 +55,7 @@ static void placeParticle(int gridX, int gridY) {
         if (grid[y][x] == Particle::WALL && selectedParticle != Particle::WALL) {
           continue;
         }
-        grid[y][x] = selectedParticle;
+        setCell(x, y, selectedParticle);
         tempSet(x, y, getParticleTemperature(selectedParticle));
         dirtySet(x, y);
       }
@@ -139,7 +142,7 @@ int handleSettingsMenuInput(int& selectedItem) {
             if (selectedItem > 0) selectedItem--;
             break;
           case KEYCODE_DOWN:
-            if (selectedItem < 1) selectedItem++;
+            if (selectedItem < 2) selectedItem++;
             break;
           case KEYCODE_EXE:
             if (event.data.key.direction == KEY_PRESSED) {
@@ -253,6 +256,47 @@ int handleSimSpeedInput(int& selectedMode) {
   return 0;
 }
 
+// Handle heat propagation sub-menu input.
+// Returns 1=confirmed, -1=cancelled, 0=navigating.
+int handleHeatModeInput(int& selectedMode) {
+  struct Input_Event event;
+  memset(&event, 0, sizeof(event));
+
+  while (GetInput(&event, 0, 0x10) == 0 && event.type != EVENT_NONE) {
+    if (event.type == EVENT_KEY) {
+      if (event.data.key.direction == KEY_PRESSED ||
+          event.data.key.direction == KEY_HELD) {
+        switch (event.data.key.keyCode) {
+          case KEYCODE_UP:
+            if (selectedMode > 0) selectedMode--;
+            break;
+          case KEYCODE_DOWN:
+            if (selectedMode < HEAT_MODE_MAX) selectedMode++;
+            break;
+          case KEYCODE_EXE:
+            if (event.data.key.direction == KEY_PRESSED) {
+              memset(&event, 0, sizeof(event));
+              return 1;
+            }
+            break;
+          case KEYCODE_POWER_CLEAR:
+            if (event.data.key.direction == KEY_PRESSED) {
+              memset(&event, 0, sizeof(event));
+              return -1;
+            }
+            break;
+          default: break;
+        }
+      }
+    } else if (event.type == EVENT_ACTBAR_ESC) {
+      memset(&event, 0, sizeof(event));
+      return -1;
+    }
+    memset(&event, 0, sizeof(event));
+  }
+  return 0;
+}
+
 // Handle input, returns true if should exit
 bool handleInput() {
   struct Input_Event event;
@@ -328,6 +372,33 @@ bool handleInput() {
         tempViewEnabled = !tempViewEnabled;
         memset(dirty, 0xFF, sizeof(dirty)); // color mode changed — repaint every cell
       }
+      // 1 key: toggle the per-phase profiler overlay
+      if (event.data.key.keyCode == KEYCODE_1 &&
+          event.data.key.direction == KEY_PRESSED) {
+        profilerEnabled = !profilerEnabled;
+        if (profilerEnabled) profilerReset();
+        else memset(dirty, 0xFF, sizeof(dirty)); // repaint the cells under the overlay
+      }
+      // 3 key: start a performance trace; press again to stop and save it to MCS
+      if (event.data.key.keyCode == KEYCODE_3 &&
+          event.data.key.direction == KEY_PRESSED) {
+        if (!traceRecording) {
+          if (traceFailed) memset(dirty, 0xFF, sizeof(dirty)); // clear ERR
+          traceStart();
+        } else {
+          // Nothing recorded or the MCS write failed: ERR replaces REC
+          traceFailed = !traceStop();
+          memset(dirty, 0xFF, sizeof(dirty)); // repaint the cells under the marker
+        }
+      }
+#ifdef PHYSICS_COUNTERS
+      // 2 key: toggle the per-type event counter overlay
+      if (event.data.key.keyCode == KEYCODE_2 &&
+          event.data.key.direction == KEY_PRESSED) {
+        countersViewEnabled = !countersViewEnabled;
+        if (!countersViewEnabled) memset(dirty, 0xFF, sizeof(dirty));
+      }
+#endif
       // Exit with EXE key
       if (event.data.key.keyCode == KEYCODE_EXE && 
           event.data.key.direction == KEY_PRESSED) {
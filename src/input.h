@@ -12,6 +12,9 @@ extern int brushSize;
 // Toggle temperature heat-map overlay (0 key)
 extern bool tempViewEnabled;
 
+// Toggle the event-counter overlay (2 key; PHYSICS_COUNTERS builds only)
+extern bool countersViewEnabled;
+
 // Handle input, returns true if should exit
 bool handleInput();
 
@@ -46,4 +49,8 @@ int handleOCInput(int& selectedLevel);
 // Returns  1 : confirmed   -1 : cancelled   0 : navigating
 int handleSimSpeedInput(int& selectedMode);
 
+// Handle heat propagation sub-menu input.
+// Returns  1 : confirmed   -1 : cancelled   0 : navigating
+int handleHeatModeInput(int& selectedMode);
+
 #endif // INPUT_H
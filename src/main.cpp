@@ -19,6 +19,9 @@
 #include "input.h"
 #include "settings.h"
 #include "overclock.h"
+#include "profiler.h"
+#include "frametime.h"
+#include "trace.h"
 
 APP_NAME("Falling Sand")
 APP_AUTHOR("SPLATPLAYS")
@@ -45,6 +48,9 @@ int main(int argc, char **argv, char **envp) {
   // Apply the persisted overclock level (level 0 = default = no register write).
   oclock_apply(overclockLevel);
 
+  // Apply the persisted heat propagation mode
+  setHeatSchedule(heatModePasses[heatMode], heatModeLevels[heatMode]);
+
   // Get actual LCD dimensions and initialize renderer
   unsigned int width, height;
   LCD_GetSize(&width, &height);
@@ -115,6 +121,24 @@ int main(int argc, char **argv, char **envp) {
                   inSim = false; // discard pending change
                 }
               }
+            } else if (settingsRow == 2) {
+              // --- Heat propagation sub-menu ---
+              int pendingMode = heatMode;
+              bool inHeat = true;
+              while (inHeat) {
+                uint16_t *hv = (uint16_t*)LCD_GetVRAMAddress();
+                drawHeatModeScreen(hv, pendingMode);
+                LCD_Refresh();
+                int heatr = handleHeatModeInput(pendingMode);
+                if (heatr == 1) {
+                  heatMode = pendingMode;
+                  setHeatSchedule(heatModePasses[heatMode], heatModeLevels[heatMode]);
+                  saveHeatMode();
+                  inHeat = false;
+                } else if (heatr == -1) {
+                  inHeat = false; // discard pending change
+                }
+              }
             }
           } else if (sr == -1) {
             inSettings = false;
@@ -146,11 +170,18 @@ int main(int argc, char **argv, char **envp) {
     uint32_t frameCount = 0;
 
     while (running) {
+      // Per-phase timing for the profiler overlay and trace; nothing is
+      // timed while both are off.
+      const bool profiling = profilerTiming();
+      uint32_t mark = profiling ? getMicros() : 0u;
+
       // Simulate physics every frame (always run, regardless of frame skip)
       simulate();
+      if (profiling) profilerLap(ProfPhase::SIMULATE, mark);
 
       // Track physics FPS every frame
       updateFPS();
+      if (profiling) profilerLap(ProfPhase::FPS, mark);
 
       // Determine if we should render this frame based on the runtime sim speed mode.
       // simSkipAmounts[0]=0 means always render; higher modes skip N frames between renders.
@@ -163,7 +194,10 @@ int main(int argc, char **argv, char **envp) {
       if (shouldRender) {
         uint16_t *vramPtr = (uint16_t*)LCD_GetVRAMAddress();
         drawGrid(vramPtr);
+        if (profiling) profilerLap(ProfPhase::DRAW, mark);
         LCD_Refresh();
+        frameTimeMark(FrameClock::RENDER);
+        if (profiling) profilerLap(ProfPhase::REFRESH, mark);
       }
 
       // Handle input every frame (even if not rendering).
@@ -171,6 +205,10 @@ int main(int argc, char **argv, char **envp) {
       if (handleInput()) {
         running = false;
       }
+      if (profiling) profilerLap(ProfPhase::INPUT, mark);
+
+      // Checked again: the 3 key may have just started or stopped the trace
+      if (profiling && traceRecording) traceRecord(frameCount, shouldRender);
 
       frameCount++;
     }
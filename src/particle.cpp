@@ -0,0 +1,8 @@
+#include "particle.h"
+
+// Runtime copy of the particle property table, placed in on-chip Y RAM next
+// to gridY so the per-cell lookups in simulate() and drawGrid() hit the same
+// fast memory as the grid rows they are working on.  Not const: a named
+// section holds one kind of data, and .oc_mem.y.data is writable (gridY), so
+// a read-only object there is a section type conflict.  Nothing writes it.
+ParticleTable particleProps OC_MEM_Y_DATA = PARTICLE_PROPS;
@@ -2,6 +2,7 @@
 #define PARTICLE_H
 
 #include "config.h"
+#include "random.h"
 
 // Ordered list of particle types shown in the UI selector bar.
 // Defined once here so renderer and input code stay in sync automatically.
@@ -19,54 +20,223 @@ constexpr Particle PARTICLE_UI_ORDER[PARTICLE_TYPE_COUNT] = {
   Particle::AIR,
 };
 
-// Get color for particle type
-inline uint16_t getParticleColor(Particle p) {
-  switch (p) {
-    case Particle::SAND:  return COLOR_SAND;
-    case Particle::WATER: return COLOR_WATER;
-    case Particle::STONE: return COLOR_STONE;
-    case Particle::WALL:  return COLOR_WALL;
-    case Particle::LAVA:  return COLOR_LAVA;
-    case Particle::PLANT: return COLOR_PLANT;
-    case Particle::ICE:   return COLOR_ICE;
-    case Particle::STEAM: return COLOR_STEAM;
-    case Particle::ACID:  return COLOR_ACID;
-    case Particle::FIRE:  return COLOR_FIRE;
-    default: return COLOR_AIR;
+// Behaviour class of a particle type.  EMPTY and STATIC cells are never
+// visited by the update loop; the rest each have a kernel in physics.cpp.
+enum class Behavior : uint8_t {
+  EMPTY,   // AIR — nothing there
+  STATIC,  // WALL — never moves or reacts
+  SOLID,   // STONE — falls straight down
+  POWDER,  // SAND, ICE — fall and pile up diagonally
+  LIQUID,  // WATER, LAVA, ACID — fall, then flow sideways
+  GAS,     // STEAM, FIRE — rise, then drift sideways
+  GROWTH,  // PLANT — static, grows and burns
+};
+
+// Per-type properties.  One row per Particle, indexed by the enum value.
+//  fallBits    shouldUpdate() lets the particle move when fallBits random
+//              bits are all zero, i.e. log2(FALL_SPEED_x) (0 = every tick)
+//  temperature default temperature written to the coarse tile on placement
+//              and after a phase change into this type
+//  density     relative density; heavier particles sink through lighter fluids
+//  hotAt/hotInto/hotBits    when the coarse tile is >= hotAt, turn into
+//              hotInto with a 1-in-2^hotBits chance per update
+//  coldAt/coldInto/coldBits when the coarse tile is <= coldAt, turn into
+//              coldInto with a 1-in-2^coldBits chance per update
+// A transition whose target is the particle itself is disabled.
+struct ParticleProps {
+  uint16_t color;
+  uint8_t  fallBits;
+  uint8_t  temperature;
+  uint8_t  density;
+  Behavior behavior;
+  uint8_t  hotAt;
+  Particle hotInto;
+  uint8_t  hotBits;
+  uint8_t  coldAt;
+  Particle coldInto;
+  uint8_t  coldBits;
+};
+
+struct ParticleTable {
+  ParticleProps rows[PARTICLE_TYPE_COUNT];
+  constexpr const ParticleProps& operator[](Particle p) const {
+    return rows[static_cast<uint8_t>(p)];
+  }
+};
+
+// Adding a particle type means one row here plus its kernel in physics.cpp.
+// Rows MUST follow the Particle enum order.
+constexpr ParticleTable PARTICLE_PROPS = {{
+  //  color        fallBits                        temperature       dens behavior            hotAt            hotInto          hotBits coldAt               coldInto         coldBits
+  { COLOR_AIR,   0,                              TEMP_AMBIENT,      2, Behavior::EMPTY,  0,               Particle::AIR,   0,      0,                   Particle::AIR,   0 },                             // AIR
+  { COLOR_SAND,  maskBits(FALL_SPEED_SAND - 1),  TEMP_AMBIENT,     16, Behavior::POWDER, TEMP_HOT,        Particle::STONE, 4,      0,                   Particle::SAND,  0 },                             // SAND
+  { COLOR_WATER, maskBits(FALL_SPEED_WATER - 1), TEMP_COLD,        10, Behavior::LIQUID, TEMP_HOT,        Particle::STEAM, 3,      TEMP_FREEZE_WATER,   Particle::ICE,   2 },                             // WATER
+  { COLOR_STONE, maskBits(FALL_SPEED_STONE - 1), TEMP_AMBIENT,     20, Behavior::SOLID,  TEMP_STONE_MELT, Particle::LAVA,  5,      0,                   Particle::STONE, 0 },                             // STONE
+  { COLOR_WALL,  0,                              TEMP_AMBIENT,    255, Behavior::STATIC, 0,               Particle::WALL,  0,      0,                   Particle::WALL,  0 },                             // WALL
+  { COLOR_LAVA,  maskBits(FALL_SPEED_LAVA - 1),  TEMP_LAVA,        14, Behavior::LIQUID, 0,               Particle::LAVA,  0,      0,                   Particle::LAVA,  0 },                             // LAVA
+  { COLOR_PLANT, 0,                              TEMP_AMBIENT,    255, Behavior::GROWTH, TEMP_HOT,        Particle::AIR,   2,      0,                   Particle::PLANT, 0 },                             // PLANT
+  { COLOR_ICE,   maskBits(FALL_SPEED_ICE - 1),   TEMP_ICE_SURFACE, 12, Behavior::POWDER, TEMP_ICE_MELT,   Particle::WATER, 3,      0,                   Particle::ICE,   0 },                             // ICE
+  { COLOR_STEAM, maskBits(FALL_SPEED_STEAM - 1), TEMP_STEAM,        1, Behavior::GAS,    0,               Particle::STEAM, 0,      TEMP_STEAM_CONDENSE, Particle::WATER, maskBits(STEAM_CONDENSE_MASK) }, // STEAM
+  { COLOR_ACID,  maskBits(FALL_SPEED_ACID - 1),  TEMP_AMBIENT,     11, Behavior::LIQUID, 0,               Particle::ACID,  0,      0,                   Particle::ACID,  0 },                             // ACID
+  { COLOR_FIRE,  maskBits(FALL_SPEED_FIRE - 1),  TEMP_FIRE,         0, Behavior::GAS,    0,               Particle::FIRE,  0,      0,                   Particle::FIRE,  0 },                             // FIRE
+}};
+
+// Chance widths must fit RandomBits::bits() and a particle with both
+// transitions must have a gap between them, or it would flip-flop inside a
+// single tile.
+constexpr bool particlePropsConsistent() {
+  for (int i = 0; i < PARTICLE_TYPE_COUNT; i++) {
+    const Particle p = static_cast<Particle>(i);
+    const ParticleProps& pp = PARTICLE_PROPS[p];
+    if (pp.fallBits > 16 || pp.hotBits > 16 || pp.coldBits > 16) return false;
+    if (pp.hotInto != p && pp.coldInto != p && pp.coldAt >= pp.hotAt) return false;
+  }
+  return true;
+}
+static_assert(particlePropsConsistent(), "PARTICLE_PROPS rows are inconsistent");
+
+// Runtime copy of PARTICLE_PROPS in on-chip Y RAM next to the middle grid
+// rows (particle.cpp, ~130 bytes).  Hot paths that index by a runtime
+// Particle read this copy with a single indexed load; code that indexes by
+// a compile-time constant should use PARTICLE_PROPS so the field folds to
+// an immediate.  Writable only because of its section (see particle.cpp);
+// treat it as read-only.
+extern ParticleTable particleProps;
+
+// Thermally neutral band derived from the table: inside
+// [TEMP_NEUTRAL_MIN, TEMP_NEUTRAL_MAX] no particle that can come to rest
+// (everything except gases; lava has no table transition) has a phase change
+// due.  temperatureTick() keeps the cells of every tile outside this
+// band awake so sleeping chunks still react to heat or cold arriving by
+// diffusion.
+constexpr uint8_t neutralBandLimit(bool upper) {
+  int lo = 0;
+  int hi = 255;
+  for (int i = 0; i < PARTICLE_TYPE_COUNT; i++) {
+    const Particle p = static_cast<Particle>(i);
+    const ParticleProps& pp = PARTICLE_PROPS[p];
+    if (pp.behavior == Behavior::GAS) continue;
+    if (pp.coldInto != p && pp.coldAt + 1 > lo) lo = pp.coldAt + 1;
+    if (pp.hotInto  != p && pp.hotAt  - 1 < hi) hi = pp.hotAt  - 1;
   }
+  return static_cast<uint8_t>(upper ? hi : lo);
 }
+constexpr uint8_t TEMP_NEUTRAL_MIN = neutralBandLimit(false);
+constexpr uint8_t TEMP_NEUTRAL_MAX = neutralBandLimit(true);
+static_assert(TEMP_NEUTRAL_MIN <= TEMP_AMBIENT && TEMP_AMBIENT <= TEMP_NEUTRAL_MAX,
+              "ambient temperature must be thermally neutral");
 
-// Get fall speed for a particle type (lower = faster)
-inline int getFallSpeed(Particle p) {
-  switch (p) {
-    case Particle::STONE: return FALL_SPEED_STONE;
-    case Particle::SAND:  return FALL_SPEED_SAND;
-    case Particle::WATER: return FALL_SPEED_WATER;
-    case Particle::LAVA:  return FALL_SPEED_LAVA;
-    case Particle::ICE:   return FALL_SPEED_ICE;
-    case Particle::STEAM: return FALL_SPEED_STEAM;
-    case Particle::ACID:  return FALL_SPEED_ACID;
-    case Particle::FIRE:  return FALL_SPEED_FIRE;
-    default: return 1; // Stationary particles, doesn't matter
+// Phase-change classes.  Every enabled table transition (a type's cold or
+// hot one) gets a bit, in enum order, cold before hot; PHASE_DUE[t] has the
+// bit of every transition due at coarse temperature t.  World::phaseDue
+// keeps that mask per tile, so a kernel learns whether its particle has a
+// phase change due — and which one — from one byte and a constant mask.
+struct PhaseBits {
+  uint8_t cold;  // 0 when the transition is disabled (never due)
+  uint8_t hot;
+};
+
+struct PhaseBitTable {
+  PhaseBits rows[PARTICLE_TYPE_COUNT];
+  int count;  // enabled transitions
+  constexpr const PhaseBits& operator[](Particle p) const {
+    return rows[static_cast<uint8_t>(p)];
   }
+};
+
+constexpr PhaseBitTable buildPhaseBitTable() {
+  PhaseBitTable table = {};
+  for (int i = 0; i < PARTICLE_TYPE_COUNT; i++) {
+    const Particle p = static_cast<Particle>(i);
+    const ParticleProps& pp = PARTICLE_PROPS[p];
+    if (pp.coldInto != p) table.rows[i].cold = static_cast<uint8_t>(1u << table.count++);
+    if (pp.hotInto  != p) table.rows[i].hot  = static_cast<uint8_t>(1u << table.count++);
+  }
+  return table;
+}
+
+constexpr PhaseBitTable PHASE_BITS = buildPhaseBitTable();
+static_assert(PHASE_BITS.count <= 8, "phase-change classes are 8-bit masks");
+
+struct PhaseDueTable {
+  uint8_t rows[256];
+  constexpr uint8_t operator[](uint8_t t) const { return rows[t]; }
+};
+
+constexpr PhaseDueTable buildPhaseDueTable() {
+  PhaseDueTable table = {};
+  for (int t = 0; t < 256; t++) {
+    for (int i = 0; i < PARTICLE_TYPE_COUNT; i++) {
+      const Particle p = static_cast<Particle>(i);
+      const ParticleProps& pp = PARTICLE_PROPS[p];
+      if (pp.coldInto != p && t <= pp.coldAt) table.rows[t] |= PHASE_BITS[p].cold;
+      if (pp.hotInto  != p && t >= pp.hotAt)  table.rows[t] |= PHASE_BITS[p].hot;
+    }
+  }
+  return table;
+}
+
+constexpr PhaseDueTable PHASE_DUE = buildPhaseDueTable();
+static_assert(PHASE_DUE[TEMP_AMBIENT] == PHASE_BITS[Particle::STEAM].cold,
+              "only steam has a phase change due at ambient temperature");
+
+// Displacement table derived from density.  Bit b of PARTICLE_DISPLACES[a]
+// is set when a particle of type a may move into a cell holding type b (the
+// two swap).  Only fluids (AIR, liquids, gases) can be displaced.  Gases move
+// into denser fluids — they rise — while powders, solids and liquids move
+// into lighter ones, so dense materials layer correctly: sand and stone sink
+// through water, lava and acid, lava and acid sink through water, steam
+// bubbles up through liquids.  A mover's row is a 16-bit mask so the check is
+// one shift-and-mask with no comparisons; kernels pass a constant mover and
+// the row folds to an immediate.
+constexpr bool isFluid(Behavior b) {
+  return b == Behavior::EMPTY || b == Behavior::LIQUID || b == Behavior::GAS;
+}
+
+constexpr bool isMover(Behavior b) {
+  return b == Behavior::SOLID || b == Behavior::POWDER ||
+         b == Behavior::LIQUID || b == Behavior::GAS;
+}
+
+constexpr bool displaces(Particle mover, Particle target) {
+  const ParticleProps& m = PARTICLE_PROPS[mover];
+  const ParticleProps& t = PARTICLE_PROPS[target];
+  if (!isMover(m.behavior) || !isFluid(t.behavior)) return false;
+  return m.behavior == Behavior::GAS ? m.density < t.density
+                                     : m.density > t.density;
+}
+
+struct DisplacementTable {
+  uint16_t rows[PARTICLE_TYPE_COUNT];
+  constexpr uint16_t operator[](Particle p) const {
+    return rows[static_cast<uint8_t>(p)];
+  }
+};
+
+constexpr DisplacementTable buildDisplacementTable() {
+  DisplacementTable table = {};
+  for (int a = 0; a < PARTICLE_TYPE_COUNT; a++)
+    for (int b = 0; b < PARTICLE_TYPE_COUNT; b++)
+      if (displaces(static_cast<Particle>(a), static_cast<Particle>(b)))
+        table.rows[a] |= static_cast<uint16_t>(1u << b);
+  return table;
+}
+
+static_assert(PARTICLE_TYPE_COUNT <= 16, "displacement rows are 16-bit masks");
+constexpr DisplacementTable PARTICLE_DISPLACES = buildDisplacementTable();
+static_assert(displaces(Particle::SAND, Particle::WATER) &&
+              displaces(Particle::ICE, Particle::WATER) &&
+              !displaces(Particle::WATER, Particle::SAND),
+              "sand and ice must keep sinking through water");
+
+// Get color for particle type
+inline uint16_t getParticleColor(Particle p) {
+  return particleProps[p].color;
 }
 
 // Get default temperature for a particle type
 inline uint8_t getParticleTemperature(Particle p) {
-  switch (p) {
-    case Particle::LAVA: return TEMP_LAVA;      // Very hot
-    case Particle::WATER: return TEMP_COLD;     // Cool
-    case Particle::SAND: return TEMP_AMBIENT;
-    case Particle::STONE: return TEMP_AMBIENT;
-    case Particle::WALL: return TEMP_AMBIENT;
-    case Particle::PLANT: return TEMP_AMBIENT;
-    case Particle::ICE:   return TEMP_ICE_SURFACE;  // Coldest — freezes surroundings
-    case Particle::STEAM: return TEMP_STEAM;         // Hot — freshly evaporated
-    case Particle::ACID:  return TEMP_AMBIENT;
-    case Particle::FIRE:  return TEMP_FIRE;
-    case Particle::AIR:   return TEMP_AMBIENT;
-    default: return TEMP_AMBIENT;
-  }
+  return particleProps[p].temperature;
 }
 
 // Get color for a particle with a small coordinate-derived variation.
@@ -1,683 +1,22 @@
 #include "physics.h"
 #include "grid.h"
-#include "particle.h"
-#include "random.h"
-#include <cstring>
+#include "simulation.h"
 
-// Check if a particle should update this frame based on its fall speed.
-// Fall speeds MUST be powers of 2 (enforced by static_assert in config.h) so
-// that the cheap bitwise AND replaces the integer division that `%` compiles to
-// on SH4 (which has no hardware divide instruction — it is a software call).
-static bool shouldUpdate(Particle p) {
-  int fallSpeed = getFallSpeed(p);
-  if (fallSpeed <= 1) return true;  // skip PRNG call for always-update particles
-  return (xorshift32() & (fallSpeed - 1)) == 0;
-}
-
-// Propagate temperature: diffuse heat between coarse cells then re-inject
-// particle-sourced heat/cold.  The coarse grid is only 24×48 (1,152 cells)
-// so running every physics tick is negligible cost.
-static ILRAM_FUNC void propagateTemperature() {
-  // --- Step 1: Diffusion + ambient cooling ---
-  // Run TEMP_DIFFUSION_PASSES passes so heat spreads TEMP_DIFFUSION_PASSES
-  // coarse cells per tick — visibly flowing away from lava into neighbours.
-  // Each pass: blend with 4-neighbour average using power-of-2 divisor so
-  // the SH4 (no hardware divide) can use a cheap right-shift instead.
-  // Weights: self×4 + each present neighbour×1, then >>3 (÷8).
-  // Ambient drift runs only on the final pass to avoid over-cooling during
-  // the intermediate passes.
-  // Pure diffusion — no ambient drift here; cooling is applied per‑tile
-  // in Step 2 where we know the context (air / water / buried).
-  for (int pass = 0; pass < TEMP_DIFFUSION_PASSES; pass++) {
-    for (int cy = 0; cy < TEMP_GRID_H; cy++) {
-      for (int cx = 0; cx < TEMP_GRID_W; cx++) {
-        int t = temperature[cy][cx];
-        // Clamp missing edge neighbours to the cell's own value so absent
-        // borders don't artificially cool/heat edge cells.
-        int tL = (cx > 0)               ? (int)temperature[cy][cx - 1] : t;
-        int tR = (cx < TEMP_GRID_W - 1) ? (int)temperature[cy][cx + 1] : t;
-        int tU = (cy > 0)               ? (int)temperature[cy - 1][cx] : t;
-        int tD = (cy < TEMP_GRID_H - 1) ? (int)temperature[cy + 1][cx] : t;
-        // Always exactly 8 contributions → safe power-of-2 shift
-        temperature[cy][cx] = static_cast<uint8_t>(((t << 2) + tL + tR + tU + tD) >> 3);
-      }
-    }
-  }
-
-  // --- Step 2: Inject sources / sinks from actual particles ---
-  // Only process coarse rows above the UI zone; rows at or below
-  // TEMP_UI_COARSE_ROW are always pinned to TEMP_AMBIENT (cleared below).
-  for (int cy = 0; cy < TEMP_UI_COARSE_ROW; cy++) {
-    for (int cx = 0; cx < TEMP_GRID_W; cx++) {
-      const int fineX0 = cx * TEMP_SCALE;
-      const int fineY0 = cy * TEMP_SCALE;
-      bool hasLava  = false;
-      bool hasFire  = false;
-      bool hasWater = false;
-      bool hasIce   = false;
-      int  wallCount = 0;
-      int  airCount  = 0;
-      for (int dy = 0; dy < TEMP_SCALE; dy++) {
-        for (int dx = 0; dx < TEMP_SCALE; dx++) {
-          Particle p = grid[fineY0 + dy][fineX0 + dx];
-          if      (p == Particle::LAVA)  { hasLava = true; }
-          else if (p == Particle::FIRE)  { hasFire = true; }
-          else if (p == Particle::ICE)   { hasIce  = true; }
-          else if (p == Particle::WALL)  { wallCount++; }
-          else if (p == Particle::WATER) { hasWater = true; }
-          else if (p == Particle::AIR)   { airCount++; }
-        }
-      }
-      const bool allWall = (wallCount == TEMP_SCALE * TEMP_SCALE);
-      if (hasLava) {
-        // Lava pins its tile to maximum heat — it is a continuous heat source.
-        temperature[cy][cx] = TEMP_LAVA;
-      } else if (hasFire) {
-        // Fire heats its tile toward TEMP_FIRE (220) — strong but not instant like lava.
-        int t = static_cast<int>(temperature[cy][cx]);
-        if (t < TEMP_FIRE) t += 4;
-        if (t > TEMP_FIRE) t = TEMP_FIRE;
-        temperature[cy][cx] = static_cast<uint8_t>(t);
-      } else if (allWall) {
-        // Entirely-wall tile: thermal insulator, always ambient.
-        temperature[cy][cx] = TEMP_AMBIENT;
-      } else if (hasIce) {
-        // ICE is a continuous cold source — pins tile to minimum cold.
-        temperature[cy][cx] = TEMP_ICE_SURFACE;
-      } else {
-        // Context-aware cooling:
-        //  • Water present  → aggressively cool toward TEMP_COLD
-        //  • Air present    → slow drift toward TEMP_AMBIENT (1/tick)
-        //  • Buried (solid) → negligible cooling (1-in-16 chance)
-        int t = static_cast<int>(temperature[cy][cx]);
-        if (hasWater) {
-          t -= TEMP_WATER_COOL_RATE;
-          if (t < TEMP_COLD) t = TEMP_COLD;
-        } else if (airCount > 0) {
-          if      (t > TEMP_AMBIENT) t--;
-          else if (t < TEMP_AMBIENT) t++;
-        } else {
-          // Buried — very slowly return to ambient
-          if (t != TEMP_AMBIENT && (xorshift32() & TEMP_BURIED_COOL_MASK) == 0) {
-            if (t > TEMP_AMBIENT) t--;
-            else                  t++;
-          }
-        }
-        temperature[cy][cx] = static_cast<uint8_t>(t);
-      }
-      // (no separate comment needed — cooling handled above)
-    }
-  }
-
-  // Pin UI-zone coarse rows to TEMP_AMBIENT so heat never bleeds behind
-  // the particle-selector bar.  memset is used here rather than a loop so
-  // the compiler can trivially verify the write is within bounds.
-  memset(&temperature[TEMP_UI_COARSE_ROW][0], TEMP_AMBIENT,
-         (TEMP_GRID_H - TEMP_UI_COARSE_ROW) * TEMP_GRID_W);
-}
-
-// Update sand particle
-static void updateSand(int x, int y) {
-  // Temperature: sustained heat (from nearby lava) converts sand to stone
-  if (tempGet(x, y) >= TEMP_HOT && (xorshift32() & 0xFu) == 0) {
-    grid[y][x] = Particle::STONE;
-    tempSet(x, y, TEMP_AMBIENT);
-    return;
-  }
-
-  // Try to fall straight down
-  if (canMoveTo(x, y + 1, Particle::SAND)) {
-    swap(x, y, x, y + 1);
-    updatedSet(x, y);
-    updatedSet(x, y + 1);
-  }
-  // Try diagonals — randomize which side is tried first to avoid left-bias
-  else {
-    bool tryLeftFirst = (xorshift32() & 1) == 0;
-    int d1 = tryLeftFirst ? -1 : 1;
-    int d2 = -d1;
-    if (canMoveTo(x + d1, y + 1, Particle::SAND)) {
-      swap(x, y, x + d1, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d1, y + 1);
-    }
-    else if (canMoveTo(x + d2, y + 1, Particle::SAND)) {
-      swap(x, y, x + d2, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d2, y + 1);
-    }
-  }
-}
-
-// Update water particle
-static void updateWater(int x, int y) {
-  // Temperature: freezing cold converts water to ice
-  if (tempGet(x, y) <= TEMP_FREEZE_WATER && (xorshift32() & 0x3u) == 0) {
-    grid[y][x] = Particle::ICE;
-    tempSet(x, y, TEMP_ICE_SURFACE);
-    return;
-  }
-
-  // Temperature: high heat evaporates water — emits hot steam
-  if (tempGet(x, y) >= TEMP_HOT && (xorshift32() & 0x7u) == 0) {
-    grid[y][x] = Particle::STEAM;
-    tempSet(x, y, TEMP_STEAM);   // steam carries the heat away
-    return;
-  }
-
-  // Try to fall straight down (only into empty space)
-  if (isEmpty(x, y + 1)) {
-    swap(x, y, x, y + 1);
-    updatedSet(x, y);
-    updatedSet(x, y + 1);
-    return;
-  }
-  // Try diagonals — randomize which side is tried first to avoid left-bias
-  {
-    bool tryLeftFirst = (xorshift32() & 1) == 0;
-    int d1 = tryLeftFirst ? -1 : 1;
-    int d2 = -d1;
-    if (isEmpty(x + d1, y + 1)) {
-      swap(x, y, x + d1, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d1, y + 1);
-      return;
-    }
-    if (isEmpty(x + d2, y + 1)) {
-      swap(x, y, x + d2, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d2, y + 1);
-      return;
-    }
-  }
-  // Blocked below — try to flow sideways; randomize direction for balanced spreading
-  {
-    bool tryLeftFirst = (xorshift32() & 1) == 0;
-    int dir1 = tryLeftFirst ? -1 : 1;
-    int dir2 = -dir1;
-
-    if (isEmpty(x + dir1, y)) {
-      swap(x, y, x + dir1, y);
-      updatedSet(x, y);
-      updatedSet(x + dir1, y);
-    }
-    else if (isEmpty(x + dir2, y)) {
-      swap(x, y, x + dir2, y);
-      updatedSet(x, y);
-      updatedSet(x + dir2, y);
-    }
-  }
-}
-
-// Update stone particle (just falls, no sideways movement)
-static void updateStone(int x, int y) {
-  // Stone submerged in extreme heat (needs multiple nearby lava cells to
-  // push the coarse tile past TEMP_STONE_MELT) slowly melts back to lava.
-  if (tempGet(x, y) >= TEMP_STONE_MELT && (xorshift32() & 0x1Fu) == 0) {
-    grid[y][x] = Particle::LAVA;
-    tempSet(x, y, TEMP_LAVA);
-    return;
-  }
-
-  if (isEmpty(x, y + 1)) {
-    swap(x, y, x, y + 1);
-    updatedSet(x, y);
-    updatedSet(x, y + 1);
-  }
-}
-// Update ice particle — falls like sand, melts to water in warmth
-static void updateIce(int x, int y) {
-  // Temperature: warmth melts ice back to water
-  if (tempGet(x, y) >= TEMP_ICE_MELT && (xorshift32() & 0x7u) == 0) {
-    grid[y][x] = Particle::WATER;
-    tempSet(x, y, TEMP_COLD);
-    return;
-  }
-
-  // Try to fall straight down (can displace water)
-  if (canMoveTo(x, y + 1, Particle::ICE)) {
-    swap(x, y, x, y + 1);
-    updatedSet(x, y);
-    updatedSet(x, y + 1);
-  }
-  // Try diagonals — randomize which side is tried first to avoid left-bias
-  else {
-    bool tryLeftFirst = (xorshift32() & 1) == 0;
-    int d1 = tryLeftFirst ? -1 : 1;
-    int d2 = -d1;
-    if (canMoveTo(x + d1, y + 1, Particle::ICE)) {
-      swap(x, y, x + d1, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d1, y + 1);
-    }
-    else if (canMoveTo(x + d2, y + 1, Particle::ICE)) {
-      swap(x, y, x + d2, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d2, y + 1);
-    }
-  }
-}
-
-static void updateLava(int x, int y) {
-  // Isolated lava (no adjacent lava cell) slowly solidifies into stone,
-  // modelling a thin tendril of lava losing heat to its surroundings.
-  // Lava inside a larger pool (has neighbours) stays molten indefinitely.
-  bool hasAdjacentLava = false;
-  for (int dy = -1; dy <= 1 && !hasAdjacentLava; dy++) {
-    for (int dx = -1; dx <= 1 && !hasAdjacentLava; dx++) {
-      if (dx == 0 && dy == 0) continue;
-      if (isValid(x + dx, y + dy) && grid[y + dy][x + dx] == Particle::LAVA)
-        hasAdjacentLava = true;
-    }
-  }
-  // Low probability so solidification takes many seconds, not instant.
-  // Also require the coarse tile has cooled somewhat (water quenching is
-  // the main fast-solidification path).
-  if (!hasAdjacentLava && tempGet(x, y) < TEMP_LAVA &&
-      (xorshift32() & 0xFFu) == 0) {
-    grid[y][x] = Particle::STONE;
-    return;
-  }
-
-  // Check and convert adjacent particles
-  // Check all 8 neighbors for sand/water/plant
-  for (int dy = -1; dy <= 1; dy++) {
-    for (int dx = -1; dx <= 1; dx++) {
-      if (dx == 0 && dy == 0) continue;
-      int nx = x + dx;
-      int ny = y + dy;
-      if (isValid(nx, ny)) {
-        if (grid[ny][nx] == Particle::SAND) {
-          grid[ny][nx] = Particle::STONE;
-          updatedSet(nx, ny);
-        } else if (grid[ny][nx] == Particle::WATER) {
-          grid[ny][nx] = Particle::STEAM;  // Lava quenches water → hot steam
-          tempSet(nx, ny, TEMP_STEAM);
-          updatedSet(nx, ny);
-        } else if (grid[ny][nx] == Particle::ICE) {
-          grid[ny][nx] = Particle::WATER;  // Lava melts ice
-          tempSet(nx, ny, TEMP_AMBIENT);
-          updatedSet(nx, ny);
-        } else if (grid[ny][nx] == Particle::PLANT) {
-          grid[ny][nx] = Particle::STEAM;  // Burning plant → steam/smoke
-          tempSet(nx, ny, TEMP_STEAM);
-          updatedSet(nx, ny);
-        }
-      }
-    }
-  }
-  
-  // Lava occasionally emits fire particles directly above — glowing sparks
-  if (y > 0 && isEmpty(x, y - 1) && (xorshift32() & 0x3Fu) == 0) {
-    grid[y - 1][x] = Particle::FIRE;
-    tempSet(x, y - 1, TEMP_FIRE);
-    updatedSet(x, y - 1);
-  }
-
-  // Lava flows like water but slower
-  if (isEmpty(x, y + 1)) {
-    swap(x, y, x, y + 1);
-    updatedSet(x, y);
-    updatedSet(x, y + 1);
-  }
-  // Try diagonal down-left
-  else if (isEmpty(x - 1, y + 1)) {
-    swap(x, y, x - 1, y + 1);
-    updatedSet(x, y);
-    updatedSet(x - 1, y + 1);
-  }
-  // Try diagonal down-right
-  else if (isEmpty(x + 1, y + 1)) {
-    swap(x, y, x + 1, y + 1);
-    updatedSet(x, y);
-    updatedSet(x + 1, y + 1);
-  }
-  // Occasionally flow sideways (power-of-2 mask — no software divide)
-  else if ((xorshift32() & (LAVA_FLOW_CHANCE - 1)) == 0) {
-    bool tryLeftFirst = (xorshift32() & 1) == 0;
-    int dir1 = tryLeftFirst ? -1 : 1;
-    int dir2 = -dir1;
-    if (isEmpty(x + dir1, y)) {
-      swap(x, y, x + dir1, y);
-      updatedSet(x, y);
-      updatedSet(x + dir1, y);
-    }
-    else if (isEmpty(x + dir2, y)) {
-      swap(x, y, x + dir2, y);
-      updatedSet(x, y);
-      updatedSet(x + dir2, y);
-    }
-  }
-}
-
-// Update acid particle: dissolves SAND, STONE, PLANT, and ICE on contact;
-// flows like water.  Each dissolved cell has a 1-in-4 chance to also consume
-// the acid cell (acid is finite).
-static void updateAcid(int x, int y) {
-  // Orthogonal neighbour offsets
-  static const int8_t ndx[4] = {  0,  0, -1,  1 };
-  static const int8_t ndy[4] = { -1,  1,  0,  0 };
-
-  bool consumed = false;
-  for (int i = 0; i < 4 && !consumed; i++) {
-    int nx = x + ndx[i];
-    int ny = y + ndy[i];
-    if (!isValid(nx, ny)) continue;
-    Particle nb = grid[ny][nx];
-
-    bool dissolveToAir   = (nb == Particle::SAND  ||
-                            nb == Particle::STONE ||
-                            nb == Particle::PLANT);
-    bool dissolveIceToWater = (nb == Particle::ICE);
+// Chunks scanned by the most recent simulate() call (see physics.h)
+int awakeChunkCount = 0;
+int activeCellCount = 0;
 
-    if ((dissolveToAir || dissolveIceToWater) &&
-        (xorshift32() & ACID_DISSOLVE_MASK) == 0) {
-      if (dissolveIceToWater) {
-        grid[ny][nx] = Particle::WATER;
-        tempSet(nx, ny, TEMP_COLD);
-      } else {
-        grid[ny][nx] = Particle::AIR;
-      }
-      // Acid is consumed by the reaction with some probability
-      if ((xorshift32() & ACID_CONSUME_MASK) == 0) {
-        grid[y][x] = Particle::AIR;
-        consumed = true;
-      }
-    }
-  }
-  if (consumed) return;
-
-  // Flow like water: fall, then spread sideways
-  if (isEmpty(x, y + 1)) {
-    swap(x, y, x, y + 1);
-    updatedSet(x, y);
-    updatedSet(x, y + 1);
-    return;
-  }
-  // Try diagonals — randomize which side is tried first to avoid left-bias
-  {
-    bool tryLeftFirst = (xorshift32() & 1) == 0;
-    int d1 = tryLeftFirst ? -1 : 1;
-    int d2 = -d1;
-    if (isEmpty(x + d1, y + 1)) {
-      swap(x, y, x + d1, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d1, y + 1);
-      return;
-    }
-    if (isEmpty(x + d2, y + 1)) {
-      swap(x, y, x + d2, y + 1);
-      updatedSet(x, y);
-      updatedSet(x + d2, y + 1);
-      return;
-    }
-  }
-  // Blocked below — spread sideways
-  {
-    bool tryLeftFirst = (xorshift32() & 1) == 0;
-    int dir1 = tryLeftFirst ? -1 : 1;
-    int dir2 = -dir1;
-    if (isEmpty(x + dir1, y)) {
-      swap(x, y, x + dir1, y);
-      updatedSet(x, y);
-      updatedSet(x + dir1, y);
-    } else if (isEmpty(x + dir2, y)) {
-      swap(x, y, x + dir2, y);
-      updatedSet(x, y);
-      updatedSet(x + dir2, y);
-    }
-  }
-}
-
-// Update fire particle: rises, ignites PLANT neighbours, is quenched by WATER,
-// and burns out probabilistically into STEAM (smoke) or AIR.
-static void updateFire(int x, int y) {
-  // Burns out probabilistically
-  if ((xorshift32() & FIRE_BURNOUT_MASK) == 0) {
-    if (xorshift32() & 1u) {
-      grid[y][x] = Particle::STEAM;
-      tempSet(x, y, TEMP_STEAM);
-    } else {
-      grid[y][x] = Particle::AIR;
-    }
-    updatedSet(x, y);
-    return;
-  }
-
-  // Interact with orthogonal neighbours
-  static const int8_t fndx[4] = {  0,  0, -1,  1 };
-  static const int8_t fndy[4] = { -1,  1,  0,  0 };
-  for (int i = 0; i < 4; i++) {
-    int nx = x + fndx[i];
-    int ny = y + fndy[i];
-    if (!isValid(nx, ny)) continue;
-    Particle nb = grid[ny][nx];
-
-    // Water quenches fire: both become STEAM
-    if (nb == Particle::WATER) {
-      grid[y][x]  = Particle::STEAM;
-      grid[ny][nx] = Particle::STEAM;
-      tempSet(x,  y,  TEMP_STEAM);
-      tempSet(nx, ny, TEMP_STEAM);
-      updatedSet(x, y);
-      updatedSet(nx, ny);
-      return;
-    }
-
-    // Ignite adjacent PLANT (probabilistic spread)
-    if (nb == Particle::PLANT && (xorshift32() & FIRE_SPREAD_MASK) == 0) {
-      grid[ny][nx] = Particle::FIRE;
-      tempSet(nx, ny, TEMP_FIRE);
-      updatedSet(nx, ny);
-    }
-  }
-
-  // Rise upward like a hot gas
-  if (y > 0 && isEmpty(x, y - 1)) {
-    swap(x, y, x, y - 1);
-    updatedSet(x, y);
-    updatedSet(x, y - 1);
-    return;
-  }
-
-  // Diagonal rise — randomize direction to avoid left/right bias
-  bool tryLeftFirst = (xorshift32() & 1u) == 0;
-  int d1 = tryLeftFirst ? -1 : 1;
-  int d2 = -d1;
-  if (y > 0 && isEmpty(x + d1, y - 1)) {
-    swap(x, y, x + d1, y - 1);
-    updatedSet(x, y);
-    updatedSet(x + d1, y - 1);
-    return;
-  }
-  if (y > 0 && isEmpty(x + d2, y - 1)) {
-    swap(x, y, x + d2, y - 1);
-    updatedSet(x, y);
-    updatedSet(x + d2, y - 1);
-    return;
-  }
-
-  // Blocked above — drift sideways
-  if (isEmpty(x + d1, y)) {
-    swap(x, y, x + d1, y);
-    updatedSet(x, y);
-    updatedSet(x + d1, y);
-  } else if (isEmpty(x + d2, y)) {
-    swap(x, y, x + d2, y);
-    updatedSet(x, y);
-    updatedSet(x + d2, y);
-  }
-}
-
-// Update steam particle: rises while hot, drifts sideways, condenses to water when cool.
-static void updateSteam(int x, int y) {
-  // Condensation: when the coarse tile has cooled to ambient-ish levels,
-  // steam probabilistically re-condenses into water.
-  if (tempGet(x, y) <= TEMP_STEAM_CONDENSE && (xorshift32() & STEAM_CONDENSE_MASK) == 0) {
-    grid[y][x] = Particle::WATER;
-    tempSet(x, y, TEMP_COLD);  // condensed water is cool
-    return;
-  }
-
-  // Try to rise straight up
-  if (y > 0 && isEmpty(x, y - 1)) {
-    swap(x, y, x, y - 1);
-    updatedSet(x, y);
-    updatedSet(x, y - 1);
-    return;
-  }
-
-  // Try diagonal rise — randomize which side is preferred
-  bool tryLeftFirst = (xorshift32() & 1) == 0;
-  int d1 = tryLeftFirst ? -1 : 1;
-  int d2 = -d1;
-  if (y > 0 && isEmpty(x + d1, y - 1)) {
-    swap(x, y, x + d1, y - 1);
-    updatedSet(x, y);
-    updatedSet(x + d1, y - 1);
-    return;
-  }
-  if (y > 0 && isEmpty(x + d2, y - 1)) {
-    swap(x, y, x + d2, y - 1);
-    updatedSet(x, y);
-    updatedSet(x + d2, y - 1);
-    return;
-  }
-
-  // Blocked above — drift sideways
-  if (isEmpty(x + d1, y)) {
-    swap(x, y, x + d1, y);
-    updatedSet(x, y);
-    updatedSet(x + d1, y);
-  } else if (isEmpty(x + d2, y)) {
-    swap(x, y, x + d2, y);
-    updatedSet(x, y);
-    updatedSet(x + d2, y);
-  }
-}
-
-// Update plant particle
-static void updatePlant(int x, int y) {
-  // Temperature: sustained heat burns plant (range effect via coarse grid)
-  if (tempGet(x, y) >= TEMP_HOT && (xorshift32() & 0x3u) == 0) {
-    grid[y][x] = Particle::AIR;
-    return;
-  }
-
-  // Check for lava in adjacent cells - plant burns
-  for (int dy = -1; dy <= 1; dy++) {
-    for (int dx = -1; dx <= 1; dx++) {
-      if (dx == 0 && dy == 0) continue;
-      int nx = x + dx;
-      int ny = y + dy;
-      if (isValid(nx, ny) && grid[ny][nx] == Particle::LAVA) {
-        grid[y][x] = Particle::AIR;  // Burn plant
-        return;
-      }
-    }
-  }
-  
-  // Check for water in adjacent cells - plant grows
-  bool hasWater = false;
-  for (int dy = -1; dy <= 1; dy++) {
-    for (int dx = -1; dx <= 1; dx++) {
-      if (dx == 0 && dy == 0) continue;
-      int nx = x + dx;
-      int ny = y + dy;
-      if (isValid(nx, ny) && grid[ny][nx] == Particle::WATER) {
-        hasWater = true;
-        break;
-      }
-    }
-    if (hasWater) break;
-  }
-  
-  // If touching water, occasionally grow into an adjacent empty space.
-  // All % replaced with & (power-of-2 mask) to avoid software divides on SH4.
-  if (hasWater && (xorshift32() & (PLANT_GROWTH_CHANCE - 1)) == 0) {
-    // Pick from the 8 cardinal+diagonal neighbours using a lookup table indexed
-    // by the low 3 bits of the PRNG — no modulo, no dx==dy==0 guard needed.
-    static const int8_t growDx[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
-    static const int8_t growDy[8] = { -1, -1, -1, 0, 0,  1, 1, 1 };
-    for (int attempt = 0; attempt < PLANT_GROWTH_ATTEMPTS; attempt++) {
-      int idx = (int)(xorshift32() & 0x7u);
-      int nx = x + growDx[idx];
-      int ny = y + growDy[idx];
-      if (isEmpty(nx, ny)) {
-        grid[ny][nx] = Particle::PLANT;
-        break;
-      }
-    }
-  }
-}
-
-// Simulate one step
+// Simulate one step of the device world.  The kernels in simulation.h are
+// instantiated here for DeviceWorld, so its dimensions fold to constants.
 ILRAM_FUNC void simulate() {
-  // Clear update flags
-  memset(updated, 0, sizeof(updated));
-
-  // Propagate temperature (coarse 24×48 grid — cheap every frame)
-  propagateTemperature();
-
-  // Update from bottom to top, randomizing left-right order
-  for (int y = GRID_HEIGHT - 2; y >= 0; y--) {
-    // Alternate scan direction for more natural behavior
-    bool scanLeft = (y % 2) == 0;
-    
-    for (int i = 0; i < GRID_WIDTH; i++) {
-      int x = scanLeft ? i : (GRID_WIDTH - 1 - i);
-      
-      // Skip if already updated this frame
-      if (updatedGet(x, y)) continue;
-      
-      Particle p = grid[y][x];
-
-      // AIR and WALL never move — skip before any further work
-      // (bitset read, PRNG call, switch) to avoid wasting cycles on the
-      // majority of cells which are typically empty or static.
-      if (p == Particle::AIR || p == Particle::WALL) continue;
-
-      // Check if particle should update based on its density/fall speed
-      if (!shouldUpdate(p)) continue;
-      
-      switch (p) {
-        case Particle::SAND:
-          updateSand(x, y);
-          break;
-        case Particle::WATER:
-          updateWater(x, y);
-          break;
-        case Particle::STONE:
-          updateStone(x, y);
-          break;
-        case Particle::LAVA:
-          updateLava(x, y);
-          break;
-        case Particle::PLANT:
-          updatePlant(x, y);
-          break;
-        case Particle::ICE:
-          updateIce(x, y);
-          break;
-        case Particle::STEAM:
-          updateSteam(x, y);
-          break;
-        case Particle::ACID:
-          updateAcid(x, y);
-          break;
-        case Particle::FIRE:
-          updateFire(x, y);
-          break;
-        default:
-          break;
-      }
-    }
-  }
+  simulateWorld(world);
+  awakeChunkCount = world.awakeChunks;
+  activeCellCount = world.activeCells;
+}
 
-  // Accumulate this tick's changes into the render dirty bitset.
-  // dirty is OR-accumulated across multiple simulate() calls between rendered
-  // frames (frame-skip mode) and cleared by drawGrid() after each render.
-  for (int y = 0; y < GRID_HEIGHT; y++)
-    for (int w = 0; w < UPDATED_WORDS; w++)
-      dirty[y][w] |= updated[y][w];
+void setHeatSchedule(int passes, int levels) {
+  if (levels < 1) levels = 1;
+  if (levels > TEMP_HEAT_LEVELS_MAX) levels = TEMP_HEAT_LEVELS_MAX;
+  world.heatPasses = static_cast<uint8_t>(passes);
+  world.heatLevels = static_cast<uint8_t>(levels);
 }
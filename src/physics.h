@@ -6,4 +6,16 @@
 // Simulate one step of the physics
 ILRAM_FUNC void simulate();
 
+// Diffusion schedule of the device world: 'passes' blends over the coarse
+// temperature field, then 'levels' of the heat hierarchy (1 = none; at most
+// TEMP_HEAT_LEVELS_MAX).  See heatModePasses / heatModeLevels.
+void setHeatSchedule(int passes, int levels);
+
+// Number of sleep/wake chunks scanned by the most recent simulate() call
+// (out of CHUNK_ROWS × CHUNK_COLS).  A settled scene drops towards zero.
+extern int awakeChunkCount;
+
+// Number of cells updated by the most recent simulate() call
+extern int activeCellCount;
+
 #endif // PHYSICS_H
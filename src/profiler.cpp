@@ -0,0 +1,60 @@
+#include "profiler.h"
+#ifdef HOST_BUILD
+#include "shim.h"
+#else
+#include <sys/time.h>
+#endif
+
+bool profilerEnabled = false;
+uint32_t profilerLastUs[PROF_PHASE_COUNT];
+
+// Per-phase sample rings
+static uint32_t samples[PROF_PHASE_COUNT][PROFILER_WINDOW];
+static uint8_t  sampleNext[PROF_PHASE_COUNT];
+static uint8_t  sampleCount[PROF_PHASE_COUNT];
+
+// gettimeofday() is backed by TMU2 at Phi/16 on the SH7305, giving
+// sub-microsecond resolution — far more precise than clock().
+// The host build reads the shim's monotonic clock instead so wall-clock
+// adjustments cannot produce negative frame times.
+uint32_t getMicros() {
+#ifdef HOST_BUILD
+  return hostMicros();
+#else
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  // Cast seconds to uint32_t before multiplying to avoid 32-bit overflow
+  // (tv_sec wraps every ~4295 s ≈ 71 min, which is fine for delta timing).
+  return static_cast<uint32_t>(tv.tv_sec) * 1000000u
+       + static_cast<uint32_t>(tv.tv_usec);
+#endif
+}
+
+void profilerReset() {
+  for (int p = 0; p < PROF_PHASE_COUNT; p++) {
+    sampleNext[p]  = 0;
+    sampleCount[p] = 0;
+  }
+}
+
+void profilerRecord(ProfPhase phase, uint32_t us) {
+  const int p = static_cast<int>(phase);
+  profilerLastUs[p] = us;
+  samples[p][sampleNext[p]] = us;
+  sampleNext[p] = static_cast<uint8_t>((sampleNext[p] + 1) & (PROFILER_WINDOW - 1));
+  if (sampleCount[p] < PROFILER_WINDOW) sampleCount[p]++;
+}
+
+ProfStats profilerStats(ProfPhase phase) {
+  const int p = static_cast<int>(phase);
+  const int n = sampleCount[p];
+  if (n == 0) return { 0, 0, 0 };
+  uint32_t lo = UINT32_MAX, hi = 0, sum = 0;
+  for (int i = 0; i < n; i++) {
+    const uint32_t s = samples[p][i];
+    if (s < lo) lo = s;
+    if (s > hi) hi = s;
+    sum += s;
+  }
+  return { lo, sum / static_cast<uint32_t>(n), hi };
+}
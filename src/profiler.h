@@ -0,0 +1,71 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include "config.h"
+
+// Per-phase frame profiler behind the in-game overlay (1 key).
+//
+// The game loop timestamps each phase with getMicros() and simulate()
+// splits its own time into the temperature pass and the particle scan.
+// Every phase keeps its last PROFILER_WINDOW samples; drawGrid() paints
+// their min / avg / max (µs) over the top-left of the grid while enabled.
+// With the overlay off (and no trace recording) nothing is timed.
+
+// Profiled phases, in overlay order
+enum class ProfPhase : uint8_t {
+  SIMULATE,     // whole simulate() call
+  TEMPERATURE,  //   of which: propagateTemperature()
+  PARTICLES,    //   of which: the particle scan
+  FPS,          // updateFPS()
+  DRAW,         // drawGrid(), overlay included
+  REFRESH,      // LCD_Refresh()
+  INPUT,        // handleInput()
+  COUNT
+};
+constexpr int PROF_PHASE_COUNT = static_cast<int>(ProfPhase::COUNT);
+
+// Rolling window length per phase (power of 2 so the ring index is a mask)
+constexpr int PROFILER_WINDOW = 32;
+static_assert((PROFILER_WINDOW & (PROFILER_WINDOW - 1)) == 0,
+              "PROFILER_WINDOW must be a power of 2");
+
+// Overlay on/off (toggled by the 1 key in handleInput())
+extern bool profilerEnabled;
+
+// Set while a performance trace is recording (owned by trace.cpp)
+extern bool traceRecording;
+// Set when the last trace could not be saved, until the next one starts
+extern bool traceFailed;
+
+// Phases are timed while the overlay is shown or a trace is recording
+inline bool profilerTiming() { return profilerEnabled || traceRecording; }
+
+// Latest sample of each phase, copied into the trace by traceRecord()
+extern uint32_t profilerLastUs[PROF_PHASE_COUNT];
+
+// Current time in microseconds (TMU2 via gettimeofday() on the device, the
+// shim's monotonic clock on the host).  Wraps every ~71 minutes, which is
+// harmless for deltas.
+uint32_t getMicros();
+
+// Forget all samples (called when the overlay is switched on)
+void profilerReset();
+
+// Add one sample of 'us' microseconds to 'phase'
+void profilerRecord(ProfPhase phase, uint32_t us);
+
+// Record the time since 'mark' against 'phase' and move 'mark' to now
+inline void profilerLap(ProfPhase phase, uint32_t& mark) {
+  const uint32_t now = getMicros();
+  profilerRecord(phase, now - mark);
+  mark = now;
+}
+
+// Window statistics for one phase (all zero before the first sample)
+struct ProfStats {
+  uint32_t minUs, avgUs, maxUs;
+};
+ProfStats profilerStats(ProfPhase phase);
+
+#endif // PROFILER_H
@@ -1,5 +1,19 @@
 #include "random.h"
 
+// Default XorShift32 seed (also used when randomSetMode() is given 0).
+static constexpr uint32_t XORSHIFT_DEFAULT_SEED = 0x12345678;
+
 // Single definition of the shared PRNG state.
 // All translation units that include random.h use this one instance.
-uint32_t xorshift_state = 0x12345678;
+uint32_t xorshift_state = XORSHIFT_DEFAULT_SEED;
+
+RandomMode randomMode = RandomMode::SEQUENTIAL;
+uint32_t randomSeed = 0;
+uint32_t randomTick = 0;
+
+void randomSetMode(RandomMode mode, uint32_t seed) {
+  randomMode     = mode;
+  randomSeed     = seed;
+  randomTick     = 0;
+  xorshift_state = seed != 0 ? seed : XORSHIFT_DEFAULT_SEED;
+}
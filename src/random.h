@@ -2,18 +2,143 @@
 #define RANDOM_H
 
 #include <cstdint>
+#include "counters.h"
 
 // XorShift32 PRNG - fast and lightweight for embedded systems
 // State is defined once in random.cpp; all translation units share it.
 extern uint32_t xorshift_state;
 
-inline uint32_t xorshift32() {
-  uint32_t x = xorshift_state;
+// One XorShift32 step (pure; the callers decide where the state lives).
+inline uint32_t xorshiftStep(uint32_t x) {
   x ^= x << 13;
   x ^= x >> 17;
   x ^= x << 5;
-  xorshift_state = x;
   return x;
 }
 
+inline uint32_t xorshift32() {
+  xorshift_state = xorshiftStep(xorshift_state);
+  return xorshift_state;
+}
+
+// Number of set bits in a 2^n - 1 chance mask, i.e. n.  constexpr so the
+// config.h masks turn into bit counts at compile time.
+constexpr uint32_t maskBits(uint32_t mask) {
+  uint32_t n = 0;
+  while (mask & 1u) {
+    n++;
+    mask >>= 1;
+  }
+  return n;
+}
+
+// 32-bit integer mixer (lowbias32: two multiplies, three xor-shifts).  Used
+// by the counter-based mode below; SH4 has a single-cycle-issue 32-bit
+// multiply, so this costs about as much as two XorShift steps.
+inline uint32_t hashMix(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352Du;
+  x ^= x >> 15;
+  x *= 0x846CA68Bu;
+  x ^= x >> 16;
+  return x;
+}
+
+// Where simulate() gets its random words from.
+//  SEQUENTIAL  one XorShift32 stream shared by the whole tick; results depend
+//              on the order cells are visited (the original behaviour)
+//  COUNTER     stateless: the words drawn while updating cell (x, y) are
+//              hashMix(key(x, y, tick, seed) + stream), stream = 0, 1, 2...
+//              counting words used by that cell.  Every decision is a pure
+//              function of position and time, so the cell visit order can
+//              change (reordered scans, parallel strips) without changing
+//              the randomness any cell sees.
+enum class RandomMode : uint8_t {
+  SEQUENTIAL,
+  COUNTER,
+};
+
+// Mode, seed and tick counter for counter mode (random.cpp).  randomTick
+// advances once per simulate() call in either mode.
+extern RandomMode randomMode;
+extern uint32_t randomSeed;
+extern uint32_t randomTick;
+
+// Select the RNG mode.  Resets the tick counter, and re-seeds the sequential
+// stream too (0 is not a valid XorShift state, so it maps to the default).
+void randomSetMode(RandomMode mode, uint32_t seed);
+
+// Counter-mode key domain for coarse temperature tiles, ORed into the tile's
+// y so their draws never alias a fine cell's.  at() packs y into the upper
+// half of the key, so this lands in key bit 31, which no cell row reaches
+// (World asserts HEIGHT < RANDOM_TILE_DOMAIN and WIDTH <= 0x10000).
+constexpr uint32_t RANDOM_TILE_DOMAIN = 0x8000u;
+
+// Random-bit pool.  Most physics decisions need 1-5 random bits (coin flips,
+// fall-speed and reaction chance masks), so a 32-bit word is handed out a few
+// bits at a time and the generator only runs when the pool is dry.
+// simulate() keeps one of these in a local for the whole tick
+// (randomBegin/randomEnd) and passes it by reference, so the state stays in
+// registers or the stack frame instead of round-tripping through
+// xorshift_state for every draw.
+struct RandomBits {
+  uint32_t state;    // XorShift32 state (sequential mode)
+  uint32_t pool;     // unused bits of the current word, consumed from bit 0
+  uint32_t avail;    // number of bits left in pool
+  uint32_t tickKey;  // counter mode: hash of (seed, tick)
+  uint32_t key;      // counter mode: key of the cell being updated
+  uint32_t stream;   // counter mode: words drawn for this cell so far
+  bool     counter;  // true in RandomMode::COUNTER
+
+  // Refill the pool with a fresh 32-bit word.
+  inline void refill() {
+    if (counter) {
+      pool = hashMix(key + stream * 0x9E3779B9u);
+      stream++;
+    } else {
+      state = xorshiftStep(state);
+      pool  = state;
+    }
+    avail = 32;
+  }
+
+  // n random bits (1 <= n <= 16) in the low bits of the result.
+  inline uint32_t bits(uint32_t n) {
+    physCount(PhysCounter::RANDOM);
+    if (avail < n) refill();
+    const uint32_t r = pool & ((1u << n) - 1u);
+    pool  >>= n;
+    avail -= n;
+    return r;
+  }
+
+  // True with probability 1/(mask+1) for a 2^n - 1 mask — the pool form of
+  // `(xorshift32() & mask) == 0`.
+  inline bool chance(uint32_t mask) {
+    return bits(maskBits(mask)) == 0;
+  }
+
+  // Start the draws for position (x, y).  Counter mode keys the following
+  // words on (x, y, tick) and drops any bits left from the previous cell;
+  // sequential mode carries on with the shared stream.
+  inline void at(uint32_t x, uint32_t y) {
+    if (counter) {
+      key    = tickKey ^ ((y << 16) | x);
+      stream = 0;
+      avail  = 0;
+    }
+  }
+};
+
+// Take the shared state into a local pool, and hand it back when done.
+// Bits left in the pool at randomEnd() are discarded.
+inline RandomBits randomBegin() {
+  return { xorshift_state, 0, 0, hashMix(randomSeed ^ hashMix(randomTick)), 0, 0,
+           randomMode == RandomMode::COUNTER };
+}
+inline void randomEnd(const RandomBits& rng) {
+  xorshift_state = rng.state;
+  randomTick++;
+}
+
 #endif // RANDOM_H
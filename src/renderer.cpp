@@ -5,67 +5,31 @@
 #include "input.h"
 #include "overclock.h"
 #include "settings.h"
-#include <sys/time.h>
+#include "profiler.h"
+#include "counters.h"
+#include "frametime.h"
 #include <cstring>
 
 // Actual LCD dimensions (set at runtime)
 int lcdWidth = SCREEN_WIDTH;
 int lcdHeight = SCREEN_HEIGHT;
-
-// FPS tracking
-static uint32_t frameTimes[FPS_SAMPLE_COUNT] = {0};
-static int frameIndex = 0;
-static uint32_t lastFrameTime = 0;
-static float currentFPS = 0.0f;
+int drawnCellCount = 0;
 
 // External reference to selected particle (from input.cpp) - now via input.h
 
-// Return current time in microseconds.
-// gettimeofday() is backed by TMU2 at Phi/16 on the SH7305, giving
-// sub-microsecond resolution — far more precise than clock().
-static uint32_t getMicros() {
-  struct timeval tv;
-  gettimeofday(&tv, nullptr);
-  // Cast seconds to uint32_t before multiplying to avoid 32-bit overflow
-  // (tv_sec wraps every ~4295 s ≈ 71 min, which is fine for delta timing).
-  return static_cast<uint32_t>(tv.tv_sec) * 1000000u
-       + static_cast<uint32_t>(tv.tv_usec);
-}
-
 // Initialize renderer with LCD dimensions
 void initRenderer(int width, int height) {
   lcdWidth = width;
   lcdHeight = height;
-  
+
   // Initialize FPS tracking
-  lastFrameTime = getMicros();
-  for (int i = 0; i < FPS_SAMPLE_COUNT; i++) {
-    frameTimes[i] = 1000000u / 60u; // Assume 60 FPS initially (~16667 µs)
-  }
+  frameTimeReset();
 }
 
-// Update FPS counter
+// Update FPS counter: one physics tick has passed.  Only stamps the tick
+// clock; the rate is worked out when the counter is drawn.
 void updateFPS() {
-  uint32_t currentTime = getMicros();
-  uint32_t delta = currentTime - lastFrameTime;
-  lastFrameTime = currentTime;
-
-  // Guard against zero delta (back-to-back calls within the same microsecond)
-  if (delta == 0u) delta = 1u;
-
-  // Store frame time (µs)
-  frameTimes[frameIndex] = delta;
-  frameIndex = (frameIndex + 1) % FPS_SAMPLE_COUNT;
-
-  // Average frame time over the sample window
-  uint32_t totalTime = 0u;
-  for (int i = 0; i < FPS_SAMPLE_COUNT; i++) {
-    totalTime += frameTimes[i];
-  }
-
-  // FPS = (samples × 1,000,000 µs/s) / total_µs
-  currentFPS = (static_cast<float>(FPS_SAMPLE_COUNT) * 1000000.0f)
-             / static_cast<float>(totalTime);
+  frameTimeMark(FrameClock::TICK);
 }
 
 // Draw a 5x7 digit to VRAM
@@ -105,7 +69,7 @@ static void drawDigit(uint16_t* vram, int x, int y, int digit, uint16_t color, i
 
 // Draw FPS counter on screen
 static void drawFPS(uint16_t* vram) {
-  int fps = static_cast<int>(currentFPS + 0.5f);
+  int fps = static_cast<int>(frameTimeRate(FrameClock::TICK));
   if (fps > 99999) fps = 99999;
 
   // Erase the previous counter: max 5 digits × 6 px wide = 30 px, 7 px tall.
@@ -399,6 +363,11 @@ void drawControlsScreen(uint16_t* vram) {
     "SLIDER BRUSH SIZE",
     "+ - BRUSH SIZE",
     "0   TEMP VIEW",
+    "1   PROFILER",
+#ifdef PHYSICS_COUNTERS
+    "2   COUNTERS",
+#endif
+    "3   TRACE",
     "CLEAR RESET GRID",
     "EXE  BACK TO MENU",
   };
@@ -436,8 +405,8 @@ void drawSettingsMenu(uint16_t* vram, int selectedItem) {
   const int rowH      = 7 * scale + 8;
   const int rowStartY = 40;
 
-  static const char* const items[] = {"CPU SPEED", "SIM SPEED"};
-  constexpr int NUM_ITEMS = 2;
+  static const char* const items[] = {"CPU SPEED", "SIM SPEED", "HEAT"};
+  constexpr int NUM_ITEMS = 3;
 
   for (int i = 0; i < NUM_ITEMS; i++) {
     int rowY = rowStartY + i * rowH;
@@ -557,10 +526,129 @@ void drawSimSpeedScreen(uint16_t* vram, int selectedMode) {
   drawSettingsFooter(vram);
 }
 
+// ---------------------------------------------------------------------------
+// Heat propagation sub-menu
+// ---------------------------------------------------------------------------
+
+void drawHeatModeScreen(uint16_t* vram, int selectedMode) {
+  drawSettingsBackground(vram, "HEAT");
+
+  const int scale     = 2;
+  const int rowH      = 7 * scale + 6;
+  const int rowStartY = 38;
+
+  // Right-column description: what each tick runs
+  static const char* const desc[HEAT_MODE_MAX + 1] = {
+    "4 PASSES",            // mode 0
+    "2 PASSES + 1 LEVEL",  // mode 1
+    "1 PASS + 2 LEVELS",   // mode 2
+  };
+
+  for (int m = 0; m <= HEAT_MODE_MAX; m++) {
+    int rowY = rowStartY + m * rowH;
+    bool sel = (m == selectedMode);
+    if (sel) drawRowHighlight(vram, rowY, rowH);
+    uint16_t col = sel ? COLOR_HIGHLIGHT : COLOR_STONE;
+    if (sel) drawText(vram, 12, rowY, ">", col, scale);
+    drawText(vram, 28, rowY, heatModeNames[m], col, scale);
+    int descW = textPixelWidth(desc[m], 1);
+    drawText(vram, lcdWidth - descW - 6, rowY + (7 * scale - 7) / 2, desc[m],
+             sel ? COLOR_HIGHLIGHT : COLOR_WALL, 1);
+  }
+
+  drawSettingsFooter(vram);
+}
+
+// ---------------------------------------------------------------------------
+// Profiler overlay
+// ---------------------------------------------------------------------------
+
+// Draw 'val' right-aligned so its last digit ends at x + 5 (6 px per digit).
+static void drawNumberRight(uint16_t* vram, int x, int y, uint32_t val, uint16_t color) {
+  do {
+    drawDigit(vram, x, y, static_cast<int>(val % 10u), color);
+    val /= 10u;
+    x -= 6;
+  } while (val != 0u);
+}
+
+// Min / avg / max µs per phase over the profiler window, in a black box at
+// the top-left of the grid.  The cells underneath are repainted when the
+// overlay is switched off (see handleInput()).
+static void drawProfiler(uint16_t* vram) {
+  static const char* const labels[PROF_PHASE_COUNT] = {
+    "SIM", " TEMP", " MOVE", "FPS", "DRAW", "LCD", "INPUT",
+  };
+  const int boxX = 2, boxY = 2;
+  const int lineH = 9;
+  const int colMin = boxX + 36 + 36, colAvg = colMin + 42, colMax = colAvg + 42;
+  const int boxW = colMax + 6 + 3 - boxX;
+  const int boxH = (PROF_PHASE_COUNT + 1) * lineH + 3;
+
+  for (int py = boxY; py < boxY + boxH; py++)
+    memset(vram + py * lcdWidth + boxX, 0, (size_t)boxW * sizeof(uint16_t));
+
+  int y = boxY + 2;
+  drawText(vram, boxX + 2, y, "US", COLOR_SAND, 1);
+  drawText(vram, colMin - 12, y, "MIN", COLOR_SAND, 1);
+  drawText(vram, colAvg - 12, y, "AVG", COLOR_SAND, 1);
+  drawText(vram, colMax - 12, y, "MAX", COLOR_SAND, 1);
+  for (int p = 0; p < PROF_PHASE_COUNT; p++) {
+    y += lineH;
+    const ProfStats st = profilerStats(static_cast<ProfPhase>(p));
+    drawText(vram, boxX + 2, y, labels[p], COLOR_STONE, 1);
+    drawNumberRight(vram, colMin, y, st.minUs, COLOR_HIGHLIGHT);
+    drawNumberRight(vram, colAvg, y, st.avgUs, COLOR_HIGHLIGHT);
+    drawNumberRight(vram, colMax, y, st.maxUs, COLOR_HIGHLIGHT);
+  }
+}
+
+#ifdef PHYSICS_COUNTERS
+// Last tick's event counts per particle type (debug builds, 2 key), in a
+// black box at the bottom-left of the grid so it clears the profiler.
+static void drawCounters(uint16_t* vram) {
+  static const PhysCounter cols[] = {
+    PhysCounter::UPDATES, PhysCounter::SKIPPED, PhysCounter::MOVES,
+    PhysCounter::PROBES, PhysCounter::RANDOM,
+  };
+  constexpr int colCount = static_cast<int>(sizeof(cols) / sizeof(cols[0]));
+  const int lineH = 9;
+  const int rows  = PARTICLE_TYPE_COUNT - 1;  // every type but WALL
+  const int boxX = 2;
+  const int boxH = (rows + 1) * lineH + 3;
+  const int boxY = (GRID_UI_BOUNDARY - 1) * PIXEL_SIZE - 2 - boxH;
+  const int col0 = boxX + 36 + 36;
+  const int colW = 42;
+  const int boxW = col0 + colCount * colW + 6 + 3 - boxX;
+
+  for (int py = boxY; py < boxY + boxH; py++)
+    memset(vram + py * lcdWidth + boxX, 0, (size_t)boxW * sizeof(uint16_t));
+
+  int y = boxY + 2;
+  drawText(vram, boxX + 2, y, "TICK", COLOR_SAND, 1);
+  for (int c = 0; c <= colCount; c++) {
+    const char* name = c < colCount ? PHYS_COUNTER_NAMES[static_cast<int>(cols[c])] : "REACT";
+    drawText(vram, col0 + c * colW + 5 - textPixelWidth(name, 1), y, name, COLOR_SAND, 1);
+  }
+  for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+    if (t == static_cast<int>(Particle::WALL)) continue;
+    y += lineH;
+    const uint32_t* row = physCountersLast[t];
+    uint32_t reactions = 0;
+    for (int c = PHYS_REACTION_FIRST; c < PHYS_COUNTER_COUNT; c++) reactions += row[c];
+    drawText(vram, boxX + 2, y, PHYS_TYPE_NAMES[t], COLOR_STONE, 1);
+    for (int c = 0; c < colCount; c++)
+      drawNumberRight(vram, col0 + c * colW, y, row[static_cast<int>(cols[c])], COLOR_HIGHLIGHT);
+    drawNumberRight(vram, col0 + colCount * colW, y, reactions, COLOR_HIGHLIGHT);
+  }
+}
+#endif
+
 // Draw the grid to screen - optimized for faster VRAM writes
 ILRAM_FUNC void drawGrid(uint16_t* vram) {
   // Optimized: write scanlines directly with proper bounds checking
   // Each grid cell is PIXEL_SIZE x PIXEL_SIZE pixels
+  int drawn = 0;
   for (int y = 0; y < GRID_HEIGHT; y++) {
     int screenY = y * PIXEL_SIZE;
     uint16_t* scanline0 = vram + screenY * lcdWidth;
@@ -578,8 +666,10 @@ ILRAM_FUNC void drawGrid(uint16_t* vram) {
       scanline0[screenX + 1] = color;
       scanline1[screenX]     = color;
       scanline1[screenX + 1] = color;
+      drawn++;
     }
   }
+  drawnCellCount = drawn;
 
   // Clear dirty flags now that every changed cell has been painted.
   memset(dirty, 0, sizeof(dirty));
@@ -629,6 +719,16 @@ ILRAM_FUNC void drawGrid(uint16_t* vram) {
   // Draw FPS counter
   drawFPS(vram);
 
+  if (profilerEnabled) drawProfiler(vram);
+  // Trace marker, left of the FPS counter: REC while recording, ERR after a
+  // trace that could not be saved (cleared by the repaints handleInput()
+  // requests when either goes away)
+  if (traceRecording)   drawText(vram, FPS_DISPLAY_X - 24, FPS_DISPLAY_Y, "REC", COLOR_LAVA, 1);
+  else if (traceFailed) drawText(vram, FPS_DISPLAY_X - 24, FPS_DISPLAY_Y, "ERR", COLOR_HIGHLIGHT, 1);
+#ifdef PHYSICS_COUNTERS
+  if (countersViewEnabled) drawCounters(vram);
+#endif
+
   // Draw brush size slider
   drawBrushSlider(vram);
 
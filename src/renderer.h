@@ -11,6 +11,9 @@ extern int lcdHeight;
 // Initialize renderer with LCD dimensions
 void initRenderer(int width, int height);
 
+// Cells repainted by the last drawGrid() call (for the performance trace)
+extern int drawnCellCount;
+
 // Update FPS counter
 void updateFPS();
 
@@ -36,6 +39,9 @@ void drawOCScreen(uint16_t* vram, int selectedLevel);
 // Draw the simulation speed sub-menu.
 void drawSimSpeedScreen(uint16_t* vram, int selectedMode);
 
+// Draw the heat propagation sub-menu.
+void drawHeatModeScreen(uint16_t* vram, int selectedMode);
+
 // Draw the controls reference screen.
 void drawControlsScreen(uint16_t* vram);
 
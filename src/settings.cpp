@@ -7,9 +7,12 @@
 #define MCS_VAR_BRUSH   "BrushSz"
 #define MCS_VAR_OCLOCK  "OCLevel"
 #define MCS_VAR_SIMSPD  "SimSpd"
+#define MCS_VAR_HEAT    "HeatMd"
+#define MCS_VAR_TRACE   "PerfTrc"
 
 int overclockLevel = OC_LEVEL_DEFAULT;
 int simSpeedMode   = SIM_SPEED_MODE_DEFAULT;
+int heatMode       = HEAT_MODE_DEFAULT;
 
 // Lookup tables defined here (declared extern in config.h)
 const char* const simSpeedModeNames[SIM_SPEED_MODE_MAX + 1] = {
@@ -21,6 +24,14 @@ const char* const simSpeedModeNames[SIM_SPEED_MODE_MAX + 1] = {
 };
 const int simSkipAmounts[SIM_SPEED_MODE_MAX + 1] = {0, 1, 2, 4, 8};
 
+const char* const heatModeNames[HEAT_MODE_MAX + 1] = {
+  "FINE",      // mode 0: field passes only
+  "2 LEVELS",  // mode 1: + 2×2-tile level
+  "3 LEVELS",  // mode 2: + 2×2- and 4×4-tile levels
+};
+const int heatModePasses[HEAT_MODE_MAX + 1] = {TEMP_DIFFUSION_PASSES, 2, 1};
+const int heatModeLevels[HEAT_MODE_MAX + 1] = {1, 2, 3};
+
 // Initialize MCS folder and load persisted settings
 void initSettings() {
   // Create folder (MCS_FOLDER_EXISTS just means it already exists, which is fine)
@@ -66,6 +77,32 @@ void initSettings() {
       simSpeedMode = val;
     }
   }
+
+  // Load persisted heat propagation mode
+  data  = nullptr;
+  size  = 0;
+  name2 = nullptr;
+  if (MCS_GetVariable(MCS_FOLDER, MCS_VAR_HEAT, &vtype, &name2, &data, &size)
+      == MCS_OK && data && size >= 1) {
+    int val = static_cast<char *>(data)[0] - '0';
+    if (val >= 0 && val <= HEAT_MODE_MAX) {
+      heatMode = val;
+    }
+  }
+}
+
+// Persist current heat propagation mode as a one-character string ("0".."2")
+void saveHeatMode() {
+  char buf[2] = { static_cast<char>('0' + heatMode), '\0' };
+  enum MCS_Error saveResult = MCS_SetVariable(MCS_FOLDER, MCS_VAR_HEAT, VARTYPE_STR, 2, buf);
+  if (saveResult != MCS_OK) {
+    enum MCS_Error retryFolder = MCS_CreateFolder(MCS_FOLDER, nullptr);
+    if (retryFolder == MCS_OK || retryFolder == MCS_FOLDER_EXISTS) {
+      if (MCS_SetVariable(MCS_FOLDER, MCS_VAR_HEAT, VARTYPE_STR, 2, buf) != MCS_OK) {
+        // Give up silently
+      }
+    }
+  }
 }
 
 // Persist current simulation speed mode as a one-character string ("0".."4")
@@ -111,3 +148,13 @@ void saveBrushSize() {
     }
   }
 }
+
+// Persist the binary performance trace.  Stored as a string-typed variable
+// like the settings above; the bytes are opaque to the OS.
+bool saveTrace(const void* data, uint32_t size) {
+  void* buf = const_cast<void*>(data);
+  if (MCS_SetVariable(MCS_FOLDER, MCS_VAR_TRACE, VARTYPE_STR, size, buf) == MCS_OK) return true;
+  enum MCS_Error retryFolder = MCS_CreateFolder(MCS_FOLDER, nullptr);
+  if (retryFolder != MCS_OK && retryFolder != MCS_FOLDER_EXISTS) return false;
+  return MCS_SetVariable(MCS_FOLDER, MCS_VAR_TRACE, VARTYPE_STR, size, buf) == MCS_OK;
+}
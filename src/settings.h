@@ -10,6 +10,9 @@ extern int overclockLevel;
 // Persisted simulation speed mode (0 = full rate, 1-4 = progressively more skipping).
 extern int simSpeedMode;
 
+// Persisted heat propagation mode (0 = plain diffusion, 1-2 = hierarchy levels).
+extern int heatMode;
+
 // Initialize settings: create MCS folder and load all persisted values.
 void initSettings();
 
@@ -22,4 +25,11 @@ void saveOverclockLevel();
 // Persist current simulation speed mode to MCS
 void saveSimSpeedMode();
 
+// Persist current heat propagation mode to MCS
+void saveHeatMode();
+
+// Persist a performance trace blob (see trace.h).  Returns false if the
+// MCS write failed even after re-creating the folder.
+bool saveTrace(const void* data, uint32_t size);
+
 #endif // SETTINGS_H
@@ -0,0 +1,1298 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+// Simulation kernels, templated on the world type (see world.h).  Every
+// function takes the world it runs on as 'w', so each World<W, H, TempScale>
+// instantiation gets its own copy with the dimensions folded to constants.
+// The functions are static: each translation unit that runs a world (the
+// device simulate() in physics.cpp, host benchmarks) instantiates its own.
+//
+// Entry point: simulateWorld(w), one physics tick.
+
+#include "config.h"
+#include "particle.h"
+#include "random.h"
+#include "world.h"
+#include "profiler.h"
+#include "counters.h"
+#include <cstring>
+#ifdef HOST_BUILD
+#include "parallel.h"
+#include "shim.h"
+#include <atomic>
+
+// Host profiling: nanoseconds spent in the temperature pass (diffusion and
+// injection), summed over every tick on any world.  Harnesses read and reset
+// it to report the temperature share of a run.
+inline uint64_t hostTempPassNanos = 0;
+#endif
+
+// Check if a particle should update this frame based on its fall speed.
+// Fall speeds MUST be powers of 2 (enforced by static_assert in config.h) so
+// the table stores log2(FALL_SPEED) and a 1-in-FALL_SPEED roll is that many
+// pool bits being zero — no integer division, which `%` compiles to on SH4
+// (no hardware divide — a software call).
+static inline bool shouldUpdate(Particle p, RandomBits& rng) {
+  const uint32_t fallBits = particleProps[p].fallBits;
+  if (fallBits == 0) return true;  // skip the draw for always-update particles
+  return rng.bits(fallBits) == 0;
+}
+
+// True if a particle that shouldUpdate() skipped could still move on a later
+// tick, so its chunk must stay awake until it gets a real turn.  Only fall
+// speeds above 1 are ever skipped: sand and ice are at rest once the three
+// cells below are blocked (phase changes are covered by the temperature
+// wake); lava, steam and fire never sleep anyway.
+template <class Wd>
+static bool mayMoveLater(Wd& w, Particle p, int x, int y) {
+  if (particleProps[p].behavior == Behavior::POWDER) {
+    return w.canMoveTo(x, y + 1, p) || w.canMoveTo(x - 1, y + 1, p) ||
+           w.canMoveTo(x + 1, y + 1, p);
+  }
+  return true;
+}
+
+// Table-driven phase change for the particle 'p' at (x, y): if the coarse
+// tile is past the type's cold or hot threshold, roll the per-type chance and
+// convert.  The tile takes the new type's default temperature (AIR carries
+// none, so burnt-away plant leaves the heat where it is).  Always called with
+// a constant 'p', so the PARTICLE_PROPS fields and phase bits fold to
+// immediates; the thresholds are read from the tile's phaseDue mask, so a
+// tile in the neutral band costs one byte load and one test.
+// Returns true if the particle changed and the kernel must stop.
+template <class Wd>
+static inline bool tryPhaseChange(Wd& w, int x, int y, Particle p, RandomBits& rng) {
+  const ParticleProps& pp = PARTICLE_PROPS[p];
+  const PhaseBits& bits = PHASE_BITS[p];
+  const uint8_t due = w.phaseDueAt(x, y) & (bits.cold | bits.hot);
+  if (due == 0) return false;
+  // At most one of the two is due (see particlePropsConsistent())
+  Particle into = p;
+  if (due & bits.cold) {
+    if (rng.bits(pp.coldBits) == 0) into = pp.coldInto;
+  } else if (rng.bits(pp.hotBits) == 0) {
+    into = pp.hotInto;
+  }
+  if (into == p) return false;
+  physCount(into == pp.coldInto ? PhysCounter::PHASE_COLD : PhysCounter::PHASE_HOT);
+  w.setCell(x, y, into);
+  if (into != Particle::AIR) w.tempSet(x, y, PARTICLE_PROPS[into].temperature);
+  return true;
+}
+
+// Step 2 of propagateTemperature() for coarse tile (cx, cy): inject sources
+// and sinks from the particles actually in the tile, then keep its cells
+// awake if it has left the thermally neutral band.  What the tile holds
+// comes from its census word (see World::census), not from its fine cells.
+// The step covers 1 << stepShift ticks, so every rate is scaled by that.
+// Touches only this tile's temperature, its wake bit and the chunk
+// containing it, and returns true if the temperature changed (the caller
+// owns the thermal spans).
+template <class Wd>
+static inline bool injectTile(Wd& w, int cx, int cy, RandomBits& rng, int stepShift) {
+  const uint8_t before = w.temperature[cy][cx];
+  const int fineX0 = cx * Wd::TEMP_SCALE;
+  const int fineY0 = cy * Wd::TEMP_SCALE;
+  const uint32_t census = w.census[cy][cx];
+  const bool hasLava  = censusCount(census, CENSUS_LAVA)  != 0;
+  const bool hasFire  = censusCount(census, CENSUS_FIRE)  != 0;
+  const bool hasWater = censusCount(census, CENSUS_WATER) != 0;
+  const bool hasIce   = censusCount(census, CENSUS_ICE)   != 0;
+  const int  airCount = censusCount(census, CENSUS_AIR);
+  const bool allWall  = censusCount(census, CENSUS_WALL) == Wd::TEMP_SCALE * Wd::TEMP_SCALE;
+  if (hasLava) {
+    // Lava pins its tile to maximum heat — it is a continuous heat source.
+    w.temperature[cy][cx] = TEMP_LAVA;
+  } else if (hasFire) {
+    // Fire heats its tile toward TEMP_FIRE (220) — strong but not instant like lava.
+    int t = static_cast<int>(w.temperature[cy][cx]);
+    if (t < TEMP_FIRE) t += 4 << stepShift;
+    if (t > TEMP_FIRE) t = TEMP_FIRE;
+    w.temperature[cy][cx] = static_cast<uint8_t>(t);
+  } else if (allWall) {
+    // Entirely-wall tile: thermal insulator, always ambient.
+    w.temperature[cy][cx] = TEMP_AMBIENT;
+  } else if (hasIce) {
+    // ICE is a continuous cold source — pins tile to minimum cold.
+    w.temperature[cy][cx] = TEMP_ICE_SURFACE;
+  } else {
+    // Context-aware cooling:
+    //  • Water present  → aggressively cool toward TEMP_COLD
+    //  • Air present    → slow drift toward TEMP_AMBIENT (1/tick)
+    //  • Buried (solid) → negligible cooling (1-in-16 chance)
+    int t = static_cast<int>(w.temperature[cy][cx]);
+    if (hasWater) {
+      t -= TEMP_WATER_COOL_RATE << stepShift;
+      if (t < TEMP_COLD) t = TEMP_COLD;
+    } else if (airCount > 0) {
+      const int drift = 1 << stepShift;
+      if      (t > TEMP_AMBIENT) t = (t - drift > TEMP_AMBIENT) ? t - drift : TEMP_AMBIENT;
+      else if (t < TEMP_AMBIENT) t = (t + drift < TEMP_AMBIENT) ? t + drift : TEMP_AMBIENT;
+    } else {
+      // Buried — very slowly return to ambient (one step per roll, the
+      // roll's odds scaled by the ticks covered)
+      rng.at(cx, RANDOM_TILE_DOMAIN | cy);
+      constexpr int BURIED_BITS = static_cast<int>(maskBits(TEMP_BURIED_COOL_MASK));
+      if (t != TEMP_AMBIENT && rng.bits(BURIED_BITS - stepShift) == 0) {
+        if (t > TEMP_AMBIENT) t--;
+        else                  t++;
+      }
+    }
+    w.temperature[cy][cx] = static_cast<uint8_t>(t);
+  }
+  // (no separate comment needed — cooling handled above)
+
+  // Tiles outside the thermally neutral band may drive phase changes in
+  // resting particles, so keep their cells awake for this tick.
+  const uint8_t tNow = w.temperature[cy][cx];
+  if (w.thermalClassify(cx, cy, tNow))
+    w.chunkWakeRect(fineX0, fineY0, fineX0 + Wd::TEMP_SCALE - 1, fineY0 + Wd::TEMP_SCALE - 1);
+  return tNow != before;
+}
+
+// ---------------------------------------------------------------------------
+// Packed diffusion (SIMD within a register): four coarse tiles per 32-bit
+// word.  Byte lanes follow memory order, so the shift that moves a lane to
+// the next tile depends on the byte order (the SH4 is big-endian, hosts are
+// usually little-endian); everything else is lane-wise.
+// ---------------------------------------------------------------------------
+
+// A word of the byte-typed temperature field
+typedef uint32_t __attribute__((__may_alias__)) TempWord;
+
+constexpr bool TEMP_WORD_BIG_ENDIAN = __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+constexpr uint32_t TEMP_FIRST_LANE  = TEMP_WORD_BIG_ENDIAN ? 0xFF000000u : 0x000000FFu;
+constexpr uint32_t TEMP_LAST_LANE   = TEMP_WORD_BIG_ENDIAN ? 0x000000FFu : 0xFF000000u;
+
+// Move every lane 'n' tiles to the right / left (lanes shifted out are lost)
+static inline uint32_t lanesRight(uint32_t v, int n) {
+  return TEMP_WORD_BIG_ENDIAN ? v >> (8 * n) : v << (8 * n);
+}
+static inline uint32_t lanesLeft(uint32_t v, int n) {
+  return TEMP_WORD_BIG_ENDIAN ? v << (8 * n) : v >> (8 * n);
+}
+
+// One blend step on four lanes: ((t << 2) + l + r + u + d) >> 3 per lane.
+// The 11-bit sum does not fit a lane, so each value is split at bit 3: the
+// high parts sum to at most 4×31 + 4×31 = 248 and the low parts to at most
+// 4×7 + 4×7 = 56, and
+//   sum >> 3 == (4·hi(t) + Σhi) + ((4·lo(t) + Σlo) >> 3)
+// exactly, so no lane ever carries into the next.
+static inline uint32_t diffuseLanes(uint32_t t, uint32_t l, uint32_t r, uint32_t u, uint32_t d) {
+  constexpr uint32_t HI = 0x1F1F1F1Fu, LO = 0x07070707u;
+  const uint32_t hi = (((t >> 3) & HI) << 2) + ((l >> 3) & HI) + ((r >> 3) & HI) +
+                      ((u >> 3) & HI) + ((d >> 3) & HI);
+  const uint32_t lo = ((t & LO) << 2) + (l & LO) + (r & LO) + (u & LO) + (d & LO);
+  return hi + ((lo >> 3) & LO);
+}
+
+// Blend word 'i' of a row of N words, clamping a missing left / right
+// neighbour to the tile's own value
+template <int N>
+static inline uint32_t diffuseEdgeWord(const TempWord *up, const TempWord *row,
+                                       const TempWord *dn, int i) {
+  const uint32_t t = row[i];
+  const uint32_t l = lanesRight(t, 1) | (i > 0     ? lanesLeft(row[i - 1], 3)  : t & TEMP_FIRST_LANE);
+  const uint32_t r = lanesLeft(t, 1)  | (i < N - 1 ? lanesRight(row[i + 1], 3) : t & TEMP_LAST_LANE);
+  return diffuseLanes(t, l, r, up[i], dn[i]);
+}
+
+// One Jacobi blend step over words [i0, i1] of a coarse row of N words:
+// 'row', 'up' and 'dn' hold the values before the step ('up' / 'dn' are
+// 'row' at the top / bottom edge) and 'out' receives the result, so the
+// outcome does not depend on sweep order.  The edge words are done outside
+// the loop, which leaves it branch-free (and vectorisable on the host).
+template <int N>
+static inline void diffuseRowWords(TempWord *__restrict out, const TempWord *up,
+                                   const TempWord *row, const TempWord *dn, int i0, int i1) {
+  if (i0 == 0) out[0] = diffuseEdgeWord<N>(up, row, dn, 0);
+  if (i1 == N - 1 && N > 1) out[N - 1] = diffuseEdgeWord<N>(up, row, dn, N - 1);
+  const int first = i0 > 1 ? i0 : 1;
+  const int last  = i1 < N - 2 ? i1 : N - 2;
+  for (int i = first; i <= last; i++) {
+    const uint32_t t = row[i];
+    out[i] = diffuseLanes(t, lanesRight(t, 1) | lanesLeft(row[i - 1], 3),
+                          lanesLeft(t, 1) | lanesRight(row[i + 1], 3), up[i], dn[i]);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Heat hierarchy: level l holds the average of each 2^l × 2^l block of the
+// coarse field, so one blend there moves heat 2^l tiles.  A level is blended
+// once per tick and the change it made is added back to every tile of the
+// block above (restriction, blend, prolongation of the difference), which
+// keeps the finer detail while the far field spreads through cheap small
+// grids.
+// ---------------------------------------------------------------------------
+
+// Average each 2×2 block of 'fine' into 'coarse' (rounded)
+template <int CW, int CH>
+static void restrictLevel(const uint8_t (&fine)[2 * CH][2 * CW], uint8_t (&coarse)[CH][CW]) {
+  for (int y = 0; y < CH; y++)
+    for (int x = 0; x < CW; x++)
+      coarse[y][x] = static_cast<uint8_t>((fine[2 * y][2 * x] + fine[2 * y][2 * x + 1] +
+                                           fine[2 * y + 1][2 * x] + fine[2 * y + 1][2 * x + 1] + 2) >> 2);
+}
+
+// One Jacobi blend of a level, same weights and edge clamping as the field
+// but rounded to nearest.  A floored blend loses up to 7/8 of a degree per
+// block, and prolongLevel() hands that loss to every tile of the block each
+// tick, so a quiet field would sink below ambient.
+template <int CW, int CH>
+static void blendLevel(uint8_t (&g)[CH][CW]) {
+  uint8_t prev[CH][CW];
+  memcpy(prev, g, sizeof(prev));
+  for (int y = 0; y < CH; y++) {
+    for (int x = 0; x < CW; x++) {
+      const int t  = prev[y][x];
+      const int tL = (x > 0)      ? (int)prev[y][x - 1] : t;
+      const int tR = (x < CW - 1) ? (int)prev[y][x + 1] : t;
+      const int tU = (y > 0)      ? (int)prev[y - 1][x] : t;
+      const int tD = (y < CH - 1) ? (int)prev[y + 1][x] : t;
+      g[y][x] = static_cast<uint8_t>(((t << 2) + tL + tR + tU + tD + 4) >> 3);
+    }
+  }
+}
+
+// Add what the blend changed in each block ('after' - 'before') to its four
+// tiles in 'fine', clamped to the temperature range.  If 'changed' is given
+// it receives the columns that changed in each row of 'fine'.
+template <int CW, int CH>
+static void prolongLevel(uint8_t (&fine)[2 * CH][2 * CW], const uint8_t (&after)[CH][CW],
+                         const uint8_t (&before)[CH][CW], TempSpan *changed) {
+  for (int y = 0; y < 2 * CH; y++) {
+    int lo = 0, hi = -1;
+    for (int x = 0; x < 2 * CW; x++) {
+      const int d = after[y >> 1][x >> 1] - before[y >> 1][x >> 1];
+      if (d == 0) continue;
+      int t = fine[y][x] + d;
+      t = t < 0 ? 0 : (t > 255 ? 255 : t);
+      if (t == fine[y][x]) continue;
+      fine[y][x] = static_cast<uint8_t>(t);
+      if (hi < 0) lo = x;
+      hi = x;
+    }
+    if (changed) changed[y] = { static_cast<int16_t>(lo), static_cast<int16_t>(hi) };
+  }
+}
+
+// Run levels 1 .. w.heatLevels - 1 of the hierarchy over the field, one
+// blend each.  'swept', if given, is widened over every tile that changed.
+template <class Wd>
+static void diffuseHeatLevels(Wd& w, TempSpan *swept) {
+  constexpr int W1 = Wd::TEMP_W / 2, H1 = Wd::TEMP_H / 2;
+  constexpr int W2 = W1 / 2, H2 = H1 / 2;
+  uint8_t level1[H1][W1], start1[H1][W1];
+  restrictLevel<W1, H1>(w.temperature, level1);
+  memcpy(start1, level1, sizeof(start1));
+  if (w.heatLevels > 2) {
+    uint8_t level2[H2][W2], start2[H2][W2];
+    restrictLevel<W2, H2>(level1, level2);
+    memcpy(start2, level2, sizeof(start2));
+    blendLevel<W2, H2>(level2);
+    prolongLevel<W2, H2>(level1, level2, start2, nullptr);
+  }
+  blendLevel<W1, H1>(level1);
+  TempSpan changed[Wd::TEMP_H];
+  prolongLevel<W1, H1>(w.temperature, level1, start1, changed);
+  for (int cy = 0; cy < Wd::TEMP_H; cy++) {
+    if (changed[cy].x0 > changed[cy].x1) continue;
+    w.thermalChangedRow(cy, changed[cy].x0, changed[cy].x1);
+    if (!swept) continue;
+    if (changed[cy].x0 < swept[cy].x0) swept[cy].x0 = changed[cy].x0;
+    if (changed[cy].x1 > swept[cy].x1) swept[cy].x1 = changed[cy].x1;
+  }
+}
+
+// Run 'passes' Jacobi blend passes over the field.  Every pass reads the
+// field as it stood before the pass, so heat spreads the same way in every
+// direction.  Instead of a second field the pass keeps a pre-pass copy of
+// the row it is writing and of the row above; the row below has not been
+// written yet.
+//
+// Only the words covering each row's thermal span are blended; every other
+// tile is at its fixed point and would come out unchanged, so the result is
+// that of a full sweep.  Words that changed mark their tiles and neighbours
+// for the next pass; the mark for the row below is held back until that
+// row's own span has been taken.  'swept', if given, is widened over every
+// span a pass took: no tile outside it changed.
+template <class Wd>
+static ILRAM_FUNC void diffusePasses(Wd& w, int passes, TempSpan *swept) {
+  constexpr int N = Wd::TEMP_W / 4;
+  TempWord (*field)[N] = reinterpret_cast<TempWord (*)[N]>(w.temperature);
+  TempWord saved[2][N];
+  for (int pass = 0; pass < passes; pass++) {
+    const TempWord *above = field[0];  // pre-pass row cy - 1
+    TempSpan below = { Wd::TEMP_W, 0 };  // next-pass mark for row cy
+    for (int cy = 0; cy < Wd::TEMP_H; cy++) {
+      const TempSpan span = w.thermalSpans[cy];
+      w.thermalSpans[cy] = below;
+      below = { Wd::TEMP_W, 0 };
+      if (span.x0 > span.x1) {
+        above = field[cy];  // not written this pass
+        continue;
+      }
+      if (swept) {
+        if (span.x0 < swept[cy].x0) swept[cy].x0 = span.x0;
+        if (span.x1 > swept[cy].x1) swept[cy].x1 = span.x1;
+      }
+      TempWord *row = saved[cy & 1];
+      memcpy(row, field[cy], sizeof(saved[0]));
+      // Clamp missing edge neighbours to the cell's own value so absent
+      // borders don't artificially cool/heat edge cells: the missing row
+      // above / below reads this row.
+      const TempWord *up = (cy > 0)              ? above         : row;
+      const TempWord *dn = (cy < Wd::TEMP_H - 1) ? field[cy + 1] : row;
+      const int i0 = span.x0 >> 2, i1 = span.x1 >> 2;
+      diffuseRowWords<N>(field[cy], up, row, dn, i0, i1);
+      int lo = 0, hi = -1;  // words changed in this row
+      for (int i = i0; i <= i1; i++) {
+        const bool changed = field[cy][i] != row[i];
+        lo = (changed && hi < 0) ? i : lo;
+        hi = changed ? i : hi;
+      }
+      if (hi >= 0) {
+        const int x0 = 4 * lo, x1 = 4 * hi + 3;
+        w.thermalExtend(cy, x0 - 1, x1 + 1);
+        if (cy > 0) w.thermalExtend(cy - 1, x0, x1);
+        below = { static_cast<int16_t>(x0), static_cast<int16_t>(x1) };
+      }
+      above = row;
+    }
+  }
+}
+
+// Step 1 of propagateTemperature(), one tick's diffusion: w.heatPasses
+// blend passes over the field, then the coarser levels of the heat
+// hierarchy, if the schedule has any.  A field the passes left at rest
+// (every span empty) skips the levels.  'swept' as for diffusePasses().
+template <class Wd>
+static inline void diffuseField(Wd& w, TempSpan *swept) {
+  diffusePasses(w, w.heatPasses, swept);
+  if (w.heatLevels > 1) {
+    bool active = false;
+    for (int cy = 0; cy < Wd::TEMP_H; cy++)
+      active |= w.thermalSpans[cy].x0 <= w.thermalSpans[cy].x1;
+    if (active) diffuseHeatLevels(w, swept);
+  }
+}
+
+// Propagate temperature: diffuse heat between coarse cells then re-inject
+// particle-sourced heat/cold.  The device's coarse grid is only 40×32 (1,280
+// cells).  The sources are injected for 1 << stepShift ticks at once (see
+// temperatureTick()), with every rate scaled by that; diffusion is always
+// one tick's.
+template <class Wd>
+static ILRAM_FUNC void propagateTemperature(Wd& w, RandomBits& rng, int stepShift = 0) {
+  // --- Step 1: Diffusion ---
+  // Run w.heatPasses passes (TEMP_DIFFUSION_PASSES by default) so heat
+  // spreads that many coarse cells per tick — visibly flowing away from lava
+  // into neighbours.
+  // Each pass: blend with 4-neighbour average using power-of-2 divisor so
+  // the SH4 (no hardware divide) can use a cheap right-shift instead.
+  // Weights: self×4 + each present neighbour×1, then >>3 (÷8).
+  // Pure diffusion — no ambient drift here; cooling is applied per‑tile
+  // in Step 2 where we know the context (air / water / buried).
+  diffuseField(w, nullptr);
+
+  // --- Step 2: Inject sources / sinks from actual particles ---
+  // Only process coarse rows above the UI zone; rows at or below
+  // Wd::TEMP_UI_ROW are always pinned to TEMP_AMBIENT (cleared below).
+  for (int cy = 0; cy < Wd::TEMP_UI_ROW; cy++) {
+    int lo = 0, hi = -1;  // columns changed in this row
+    for (int cx = 0; cx < Wd::TEMP_W; cx++) {
+      if (!injectTile(w, cx, cy, rng, stepShift)) continue;
+      if (hi < 0) lo = cx;
+      hi = cx;
+    }
+    if (hi >= 0) w.thermalChangedRow(cy, lo, hi);
+  }
+
+  // Pin UI-zone coarse rows to TEMP_AMBIENT so heat never bleeds behind
+  // the particle-selector bar.
+  w.pinUiTemperature();
+}
+
+// Keep the cells of every out-of-band tile awake, as the source pass would
+// have on this tick
+template <class Wd>
+static void wakeThermalTiles(Wd& w) {
+  for (int cy = 0; cy < Wd::TEMP_UI_ROW; cy++) {
+    for (int i = 0; i < Wd::TEMP_WORDS; i++) {
+      for (uint32_t bits = w.thermalWake[cy][i]; bits; bits &= bits - 1) {
+        const int x0 = (i * 32 + __builtin_ctz(bits)) * Wd::TEMP_SCALE;
+        const int y0 = cy * Wd::TEMP_SCALE;
+        w.chunkWakeRect(x0, y0, x0 + Wd::TEMP_SCALE - 1, y0 + Wd::TEMP_SCALE - 1);
+      }
+    }
+  }
+}
+
+// Length of the next thermal step, from how many tiles lie outside the
+// neutral band (see TEMP_SUBCYCLE_MAX), at most w.heatStepMax
+template <class Wd>
+static uint8_t thermalStepLength(const Wd& w) {
+  int out = 0;
+  for (int cy = 0; cy < Wd::TEMP_UI_ROW; cy++)
+    for (int i = 0; i < Wd::TEMP_WORDS; i++)
+      out += __builtin_popcount(w.thermalWake[cy][i]);
+  constexpr int TILES = Wd::TEMP_W * Wd::TEMP_UI_ROW;
+  uint8_t step = 1;
+  if      (out < (TILES >> TEMP_SUBCYCLE_QUIET_SHIFT)) step = TEMP_SUBCYCLE_MAX;
+  else if (out <= (TILES >> TEMP_SUBCYCLE_BUSY_SHIFT)) step = 2;
+  return step < w.heatStepMax ? step : w.heatStepMax;
+}
+
+// Diffusion on a tick between thermal steps.  No source pass follows to
+// classify the tiles, so every tile the diffusion swept is classified again
+// here (phase changes due, wake bits).
+template <class Wd>
+static void diffuseBetweenSteps(Wd& w) {
+  TempSpan swept[Wd::TEMP_H];
+  for (int cy = 0; cy < Wd::TEMP_H; cy++) swept[cy] = { Wd::TEMP_W, 0 };
+  diffuseField(w, swept);
+  w.pinUiTemperature();
+  for (int cy = 0; cy < Wd::TEMP_UI_ROW; cy++)
+    for (int cx = swept[cy].x0; cx <= swept[cy].x1; cx++)
+      w.thermalClassify(cx, cy, w.temperature[cy][cx]);
+}
+
+// The temperature part of a tick.  Diffusion runs every tick.  The sources
+// of a mostly neutral field change slowly, so they are injected only every
+// thermalStep ticks, each step injecting for all of them.  On the waiting
+// ticks the wake bits are replayed, which keeps phase changes in hot and
+// cold tiles running every tick.
+template <class Wd>
+static ILRAM_FUNC void temperatureTick(Wd& w, RandomBits& rng) {
+  if (w.thermalWait > 0) {
+    w.thermalWait--;
+    diffuseBetweenSteps(w);
+    wakeThermalTiles(w);
+    return;
+  }
+  propagateTemperature(w, rng, __builtin_ctz(w.thermalStep));
+  w.thermalStep = thermalStepLength(w);
+  w.thermalWait = static_cast<uint8_t>(w.thermalStep - 1);
+}
+
+// Update sand particle
+template <class Wd>
+static void updateSand(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: sustained heat (from nearby lava) converts sand to stone
+  if (tryPhaseChange(w, x, y, Particle::SAND, rng)) return;
+
+  // Try to fall straight down
+  if (w.canMoveTo(x, y + 1, Particle::SAND)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  else {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::SAND)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+    }
+    else if (w.canMoveTo(x + d2, y + 1, Particle::SAND)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+    }
+  }
+}
+
+// Update water particle
+template <class Wd>
+static void updateWater(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: freezing cold converts water to ice; high heat evaporates
+  // it into hot steam that carries the heat away
+  if (tryPhaseChange(w, x, y, Particle::WATER, rng)) return;
+
+  // Try to fall straight down (only into empty space)
+  if (w.canMoveTo(x, y + 1, Particle::WATER)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+    return;
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::WATER)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+      return;
+    }
+    if (w.canMoveTo(x + d2, y + 1, Particle::WATER)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+      return;
+    }
+  }
+  // Blocked below — try to flow sideways; randomize direction for balanced spreading
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int dir1 = tryLeftFirst ? -1 : 1;
+    int dir2 = -dir1;
+
+    if (w.canMoveTo(x + dir1, y, Particle::WATER)) {
+      w.swap(x, y, x + dir1, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir1, y);
+    }
+    else if (w.canMoveTo(x + dir2, y, Particle::WATER)) {
+      w.swap(x, y, x + dir2, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir2, y);
+    }
+  }
+}
+
+// Update stone particle (just falls, no sideways movement)
+template <class Wd>
+static void updateStone(Wd& w, int x, int y, RandomBits& rng) {
+  // Stone submerged in extreme heat (needs multiple nearby lava cells to
+  // push the coarse tile past TEMP_STONE_MELT) slowly melts back to lava.
+  if (tryPhaseChange(w, x, y, Particle::STONE, rng)) return;
+
+  if (w.canMoveTo(x, y + 1, Particle::STONE)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+}
+// Update ice particle — falls like sand, melts to water in warmth
+template <class Wd>
+static void updateIce(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: warmth melts ice back to water
+  if (tryPhaseChange(w, x, y, Particle::ICE, rng)) return;
+
+  // Try to fall straight down (can displace water)
+  if (w.canMoveTo(x, y + 1, Particle::ICE)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  else {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::ICE)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+    }
+    else if (w.canMoveTo(x + d2, y + 1, Particle::ICE)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+    }
+  }
+}
+
+template <class Wd>
+static void updateLava(Wd& w, int x, int y, RandomBits& rng) {
+  // Lava is a perpetual source of sparks, reactions and slow flow — never sleeps.
+  w.chunkKeep(x, y);
+
+  // Isolated lava (no adjacent lava cell) slowly solidifies into stone,
+  // modelling a thin tendril of lava losing heat to its surroundings.
+  // Lava inside a larger pool (has neighbours) stays molten indefinitely.
+  bool hasAdjacentLava = false;
+  for (int dy = -1; dy <= 1 && !hasAdjacentLava; dy++) {
+    for (int dx = -1; dx <= 1 && !hasAdjacentLava; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      physCount(PhysCounter::PROBES);
+      if (w.at(x + dx, y + dy) == Particle::LAVA)
+        hasAdjacentLava = true;
+    }
+  }
+  // Low probability so solidification takes many seconds, not instant.
+  // Also require the coarse tile has cooled somewhat (water quenching is
+  // the main fast-solidification path).
+  if (!hasAdjacentLava && w.tempGet(x, y) < TEMP_LAVA &&
+      rng.chance(0xFFu)) {
+    physCount(PhysCounter::SOLIDIFY);
+    w.setCell(x, y, Particle::STONE);
+    return;
+  }
+
+  // Check and convert adjacent particles
+  // Check all 8 neighbors for sand/water/plant
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      int nx = x + dx;
+      int ny = y + dy;
+      physCount(PhysCounter::PROBES);
+      if (w.at(nx, ny) == Particle::SAND) {
+        physCount(PhysCounter::SCORCH);
+        w.setCell(nx, ny, Particle::STONE);
+        w.updatedSet(nx, ny);
+      } else if (w.at(nx, ny) == Particle::WATER) {
+        physCount(PhysCounter::QUENCH);
+        w.setCell(nx, ny, Particle::STEAM);  // Lava quenches water → hot steam
+        w.tempSet(nx, ny, TEMP_STEAM);
+        w.updatedSet(nx, ny);
+      } else if (w.at(nx, ny) == Particle::ICE) {
+        physCount(PhysCounter::MELT);
+        w.setCell(nx, ny, Particle::WATER);  // Lava melts ice
+        w.tempSet(nx, ny, TEMP_AMBIENT);
+        w.updatedSet(nx, ny);
+      } else if (w.at(nx, ny) == Particle::PLANT) {
+        physCount(PhysCounter::BURN);
+        w.setCell(nx, ny, Particle::STEAM);  // Burning plant → steam/smoke
+        w.tempSet(nx, ny, TEMP_STEAM);
+        w.updatedSet(nx, ny);
+      }
+    }
+  }
+  
+  // Lava occasionally emits fire particles directly above — glowing sparks
+  physCount(PhysCounter::PROBES);
+  if (w.at(x, y - 1) == Particle::AIR && rng.chance(0x3Fu)) {
+    physCount(PhysCounter::SPARK);
+    w.setCell(x, y - 1, Particle::FIRE);
+    w.tempSet(x, y - 1, TEMP_FIRE);
+    w.updatedSet(x, y - 1);
+  }
+
+  // Lava flows like water but slower
+  if (w.canMoveTo(x, y + 1, Particle::LAVA)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+  }
+  // Try diagonal down-left
+  else if (w.canMoveTo(x - 1, y + 1, Particle::LAVA)) {
+    w.swap(x, y, x - 1, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x - 1, y + 1);
+  }
+  // Try diagonal down-right
+  else if (w.canMoveTo(x + 1, y + 1, Particle::LAVA)) {
+    w.swap(x, y, x + 1, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + 1, y + 1);
+  }
+  // Occasionally flow sideways (power-of-2 mask — no software divide)
+  else if (rng.chance(LAVA_FLOW_CHANCE - 1)) {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int dir1 = tryLeftFirst ? -1 : 1;
+    int dir2 = -dir1;
+    if (w.canMoveTo(x + dir1, y, Particle::LAVA)) {
+      w.swap(x, y, x + dir1, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir1, y);
+    }
+    else if (w.canMoveTo(x + dir2, y, Particle::LAVA)) {
+      w.swap(x, y, x + dir2, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir2, y);
+    }
+  }
+}
+
+// Update acid particle: dissolves SAND, STONE, PLANT, and ICE on contact;
+// flows like water.  Each dissolved cell has a 1-in-4 chance to also consume
+// the acid cell (acid is finite).
+template <class Wd>
+static void updateAcid(Wd& w, int x, int y, RandomBits& rng) {
+  // Orthogonal neighbour offsets
+  static const int8_t ndx[4] = {  0,  0, -1,  1 };
+  static const int8_t ndy[4] = { -1,  1,  0,  0 };
+
+  bool consumed = false;
+  bool pending  = false;
+  for (int i = 0; i < 4 && !consumed; i++) {
+    int nx = x + ndx[i];
+    int ny = y + ndy[i];
+    physCount(PhysCounter::PROBES);
+    Particle nb = w.at(nx, ny);
+
+    bool dissolveToAir   = (nb == Particle::SAND  ||
+                            nb == Particle::STONE ||
+                            nb == Particle::PLANT);
+    bool dissolveIceToWater = (nb == Particle::ICE);
+    pending |= dissolveToAir || dissolveIceToWater;
+
+    if ((dissolveToAir || dissolveIceToWater) &&
+        rng.chance(ACID_DISSOLVE_MASK)) {
+      physCount(PhysCounter::DISSOLVE);
+      if (dissolveIceToWater) {
+        w.setCell(nx, ny, Particle::WATER);
+        w.tempSet(nx, ny, TEMP_COLD);
+      } else {
+        w.setCell(nx, ny, Particle::AIR);
+      }
+      // Acid is consumed by the reaction with some probability
+      if (rng.chance(ACID_CONSUME_MASK)) {
+        physCount(PhysCounter::CONSUMED);
+        w.setCell(x, y, Particle::AIR);
+        consumed = true;
+      }
+    }
+  }
+  if (consumed) return;
+  // A dissolvable neighbour that survived this tick's roll stays at risk.
+  if (pending) w.chunkKeep(x, y);
+
+  // Flow like water: fall, then spread sideways
+  if (w.canMoveTo(x, y + 1, Particle::ACID)) {
+    w.swap(x, y, x, y + 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y + 1);
+    return;
+  }
+  // Try diagonals — randomize which side is tried first to avoid left-bias
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int d1 = tryLeftFirst ? -1 : 1;
+    int d2 = -d1;
+    if (w.canMoveTo(x + d1, y + 1, Particle::ACID)) {
+      w.swap(x, y, x + d1, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d1, y + 1);
+      return;
+    }
+    if (w.canMoveTo(x + d2, y + 1, Particle::ACID)) {
+      w.swap(x, y, x + d2, y + 1);
+      w.updatedSet(x, y);
+      w.updatedSet(x + d2, y + 1);
+      return;
+    }
+  }
+  // Blocked below — spread sideways
+  {
+    bool tryLeftFirst = rng.bits(1) == 0;
+    int dir1 = tryLeftFirst ? -1 : 1;
+    int dir2 = -dir1;
+    if (w.canMoveTo(x + dir1, y, Particle::ACID)) {
+      w.swap(x, y, x + dir1, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir1, y);
+    } else if (w.canMoveTo(x + dir2, y, Particle::ACID)) {
+      w.swap(x, y, x + dir2, y);
+      w.updatedSet(x, y);
+      w.updatedSet(x + dir2, y);
+    }
+  }
+}
+
+// Update fire particle: rises, ignites PLANT neighbours, is quenched by WATER,
+// and burns out probabilistically into STEAM (smoke) or AIR.
+template <class Wd>
+static void updateFire(Wd& w, int x, int y, RandomBits& rng) {
+  // Fire always burns out eventually — never sleeps.
+  w.chunkKeep(x, y);
+
+  // Burns out probabilistically
+  if (rng.chance(FIRE_BURNOUT_MASK)) {
+    physCount(PhysCounter::BURNOUT);
+    if (rng.bits(1)) {
+      w.setCell(x, y, Particle::STEAM);
+      w.tempSet(x, y, TEMP_STEAM);
+    } else {
+      w.setCell(x, y, Particle::AIR);
+    }
+    w.updatedSet(x, y);
+    return;
+  }
+
+  // Interact with orthogonal neighbours
+  static const int8_t fndx[4] = {  0,  0, -1,  1 };
+  static const int8_t fndy[4] = { -1,  1,  0,  0 };
+  for (int i = 0; i < 4; i++) {
+    int nx = x + fndx[i];
+    int ny = y + fndy[i];
+    physCount(PhysCounter::PROBES);
+    Particle nb = w.at(nx, ny);
+
+    // Water quenches fire: both become STEAM
+    if (nb == Particle::WATER) {
+      physCount(PhysCounter::QUENCH);
+      w.setCell(x, y, Particle::STEAM);
+      w.setCell(nx, ny, Particle::STEAM);
+      w.tempSet(x,  y,  TEMP_STEAM);
+      w.tempSet(nx, ny, TEMP_STEAM);
+      w.updatedSet(x, y);
+      w.updatedSet(nx, ny);
+      return;
+    }
+
+    // Ignite adjacent PLANT (probabilistic spread)
+    if (nb == Particle::PLANT && rng.chance(FIRE_SPREAD_MASK)) {
+      physCount(PhysCounter::IGNITE);
+      w.setCell(nx, ny, Particle::FIRE);
+      w.tempSet(nx, ny, TEMP_FIRE);
+      w.updatedSet(nx, ny);
+    }
+  }
+
+  // Rise upward like a hot gas
+  if (w.canMoveTo(x, y - 1, Particle::FIRE)) {
+    w.swap(x, y, x, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y - 1);
+    return;
+  }
+
+  // Diagonal rise — randomize direction to avoid left/right bias
+  bool tryLeftFirst = rng.bits(1) == 0;
+  int d1 = tryLeftFirst ? -1 : 1;
+  int d2 = -d1;
+  if (w.canMoveTo(x + d1, y - 1, Particle::FIRE)) {
+    w.swap(x, y, x + d1, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y - 1);
+    return;
+  }
+  if (w.canMoveTo(x + d2, y - 1, Particle::FIRE)) {
+    w.swap(x, y, x + d2, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y - 1);
+    return;
+  }
+
+  // Blocked above — drift sideways
+  if (w.canMoveTo(x + d1, y, Particle::FIRE)) {
+    w.swap(x, y, x + d1, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y);
+  } else if (w.canMoveTo(x + d2, y, Particle::FIRE)) {
+    w.swap(x, y, x + d2, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y);
+  }
+}
+
+// Update steam particle: rises while hot, drifts sideways, condenses to water when cool.
+template <class Wd>
+static void updateSteam(Wd& w, int x, int y, RandomBits& rng) {
+  // Steam keeps drifting and eventually condenses — never sleeps.
+  w.chunkKeep(x, y);
+
+  // Condensation: when the coarse tile has cooled to ambient-ish levels,
+  // steam probabilistically re-condenses into (cool) water.
+  if (tryPhaseChange(w, x, y, Particle::STEAM, rng)) return;
+
+  // Try to rise straight up
+  if (w.canMoveTo(x, y - 1, Particle::STEAM)) {
+    w.swap(x, y, x, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x, y - 1);
+    return;
+  }
+
+  // Try diagonal rise — randomize which side is preferred
+  bool tryLeftFirst = rng.bits(1) == 0;
+  int d1 = tryLeftFirst ? -1 : 1;
+  int d2 = -d1;
+  if (w.canMoveTo(x + d1, y - 1, Particle::STEAM)) {
+    w.swap(x, y, x + d1, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y - 1);
+    return;
+  }
+  if (w.canMoveTo(x + d2, y - 1, Particle::STEAM)) {
+    w.swap(x, y, x + d2, y - 1);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y - 1);
+    return;
+  }
+
+  // Blocked above — drift sideways
+  if (w.canMoveTo(x + d1, y, Particle::STEAM)) {
+    w.swap(x, y, x + d1, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d1, y);
+  } else if (w.canMoveTo(x + d2, y, Particle::STEAM)) {
+    w.swap(x, y, x + d2, y);
+    w.updatedSet(x, y);
+    w.updatedSet(x + d2, y);
+  }
+}
+
+// Update plant particle
+template <class Wd>
+static void updatePlant(Wd& w, int x, int y, RandomBits& rng) {
+  // Temperature: sustained heat burns plant (range effect via coarse grid)
+  if (tryPhaseChange(w, x, y, Particle::PLANT, rng)) return;
+
+  // Check for lava in adjacent cells - plant burns
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      int nx = x + dx;
+      int ny = y + dy;
+      physCount(PhysCounter::PROBES);
+      if (w.at(nx, ny) == Particle::LAVA) {
+        physCount(PhysCounter::BURN);
+        w.setCell(x, y, Particle::AIR);  // Burn plant
+        return;
+      }
+    }
+  }
+  
+  // Check for water in adjacent cells - plant grows
+  bool hasWater = false;
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      int nx = x + dx;
+      int ny = y + dy;
+      physCount(PhysCounter::PROBES);
+      if (w.at(nx, ny) == Particle::WATER) {
+        hasWater = true;
+        break;
+      }
+    }
+    if (hasWater) break;
+  }
+  
+  // A watered plant may grow on any later tick, so it stays awake.
+  if (hasWater) w.chunkKeep(x, y);
+
+  // If touching water, occasionally grow into an adjacent empty space.
+  // All % replaced with & (power-of-2 mask) to avoid software divides on SH4.
+  if (hasWater && rng.chance(PLANT_GROWTH_CHANCE - 1)) {
+    // Pick from the 8 cardinal+diagonal neighbours using a lookup table indexed
+    // by the low 3 bits of the PRNG — no modulo, no dx==dy==0 guard needed.
+    static const int8_t growDx[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+    static const int8_t growDy[8] = { -1, -1, -1, 0, 0,  1, 1, 1 };
+    for (int attempt = 0; attempt < PLANT_GROWTH_ATTEMPTS; attempt++) {
+      int idx = (int)rng.bits(3);
+      int nx = x + growDx[idx];
+      int ny = y + growDy[idx];
+      physCount(PhysCounter::PROBES);
+      if (w.at(nx, ny) == Particle::AIR) {
+        physCount(PhysCounter::GROW);
+        w.setCell(nx, ny, Particle::PLANT);
+        break;
+      }
+    }
+  }
+}
+
+// Update a single cell: the per-cell body of the simulate() scan.
+// The scan only calls this for cells whose occupied bit is set and whose
+// updated bit is clear, so AIR, WALL and already-moved particles never get
+// here (no grid load, PRNG call or switch for the mostly-empty screen).
+template <class Wd>
+static inline void updateCell(Wd& w, int x, int y, RandomBits& rng) {
+  Particle p = w.at(x, y);
+  rng.at(x, y);  // counter mode: this cell's draws depend only on (x, y, tick)
+  physCountFor(p);
+  physCount(PhysCounter::UPDATES);
+
+  // Check if particle should update based on its density/fall speed.
+  // A particle that sat this tick out but is not yet at rest keeps its
+  // chunk awake until it gets a real turn.
+  if (!shouldUpdate(p, rng)) {
+    physCount(PhysCounter::SKIPPED);
+    if (mayMoveLater(w, p, x, y)) w.chunkKeep(x, y);
+    return;
+  }
+
+  switch (p) {
+    case Particle::SAND:
+      updateSand(w, x, y, rng);
+      break;
+    case Particle::WATER:
+      updateWater(w, x, y, rng);
+      break;
+    case Particle::STONE:
+      updateStone(w, x, y, rng);
+      break;
+    case Particle::LAVA:
+      updateLava(w, x, y, rng);
+      break;
+    case Particle::PLANT:
+      updatePlant(w, x, y, rng);
+      break;
+    case Particle::ICE:
+      updateIce(w, x, y, rng);
+      break;
+    case Particle::STEAM:
+      updateSteam(w, x, y, rng);
+      break;
+    case Particle::ACID:
+      updateAcid(w, x, y, rng);
+      break;
+    case Particle::FIRE:
+      updateFire(w, x, y, rng);
+      break;
+    default:
+      break;
+  }
+}
+
+// Scan grid row y: update every occupied, not-yet-updated cell inside the
+// awake rectangles of the row's chunks.  Kernels touch rows y-1..y+1 only.
+// Returns the number of cells updated (the tick's active cell count).
+template <class Wd>
+static inline int scanRow(Wd& w, int y, RandomBits& rng) {
+  int active = 0;
+  // Alternate scan direction for more natural behavior
+  bool scanLeft = (y % 2) == 0;
+  const int cy = y / CHUNK_SIZE;
+  const int ly = y % CHUNK_SIZE;
+
+  const uint32_t* occRow = w.occupied[y];
+  const uint32_t* updRow = w.updated[y];
+
+  for (int k = 0; k < Wd::CHUNK_COLS; k++) {
+    const int cx = scanLeft ? k : (Wd::CHUNK_COLS - 1 - k);
+    const ChunkRect& r = w.chunks[cy][cx].cur;
+    if (ly < r.y0 || ly > r.y1) continue;  // asleep, or row outside the rectangle
+    const int baseX = cx * CHUNK_SIZE;
+
+    // Visit only occupied, not-yet-updated cells by jumping between set
+    // bits.  The candidate word is rebuilt after every update because a
+    // kernel may move particles into (updated) or create them in (e.g.
+    // plant growth) cells further along the row.
+    if (scanLeft) {
+      int x = baseX + r.x0;
+      while (x <= baseX + r.x1) {
+        const int i = x >> 5;
+        const uint32_t bits = (occRow[i] & ~updRow[i]) >> (x & 31);
+        if (bits == 0) { x = (i + 1) << 5; continue; }
+        x += __builtin_ctz(bits);
+        if (x > baseX + r.x1) break;
+        updateCell(w, x, y, rng);
+        active++;
+        x++;
+      }
+    } else {
+      int x = baseX + r.x1;
+      while (x >= baseX + r.x0) {
+        const int i = x >> 5;
+        // Keep bits 0..(x & 31); 2u << 31 wraps to 0, giving an all-ones mask.
+        const uint32_t bits = occRow[i] & ~updRow[i] & ((2u << (x & 31)) - 1u);
+        if (bits == 0) { x = (i << 5) - 1; continue; }
+        x = (i << 5) + 31 - __builtin_clz(bits);
+        if (x < baseX + r.x0) break;
+        updateCell(w, x, y, rng);
+        active++;
+        x--;
+      }
+    }
+  }
+  return active;
+}
+
+// Start of a tick: clear update flags and make the cells woken during the
+// previous tick this tick's scan set.
+template <class Wd>
+static inline void beginTick(Wd& w) {
+  memset(w.updated, 0, sizeof(w.updated));
+  w.chunksBeginTick();
+}
+
+// End of a tick: publish the awake-chunk count and accumulate this tick's
+// changes into the render dirty bitset.  dirty is OR-accumulated across
+// multiple simulate() calls between rendered frames (frame-skip mode) and
+// cleared by drawGrid() after each render.
+template <class Wd>
+static inline void endTick(Wd& w) {
+  w.awakeChunks = w.chunksAwake();
+  for (int y = 0; y < Wd::HEIGHT; y++)
+    for (int i = 0; i < Wd::WORDS; i++)
+      w.dirty[y][i] |= w.updated[y][i];
+}
+
+#ifdef HOST_BUILD
+// ---------------------------------------------------------------------------
+// Host-only parallel tick (hostParallelThreads() > 1, see host/parallel.h).
+//
+// Particles: the grid is cut into full-width strips of two chunk rows and the
+// tick runs in two phases, one per strip parity.  A kernel reads and writes
+// at most one row beyond its own, and the chunk rectangles it wakes lie at
+// most one chunk row away, so strips of the same parity (a whole strip apart)
+// never touch the same cells, bitset words, chunk records or coarse tiles
+// (nor the thermal spans of the rows around them).
+// Within a strip rows still run bottom to top.  The phase holding the bottom
+// strip goes first, like the serial scan.
+//
+// Temperature: diffusion runs by coarse rows, each pass reading a snapshot of
+// the whole field (the serial pass is Jacobi too, so both agree), and
+// injection runs by chunk rows, since neighbouring tiles of one chunk share
+// its record.
+//
+// Randomness always comes from counter mode (RandomMode::COUNTER): every
+// draw is keyed on position and tick, so results do not depend on which
+// thread gets which strip.  They do differ from the serial order.
+// ---------------------------------------------------------------------------
+constexpr int STRIP_ROWS = 2 * CHUNK_SIZE;
+
+template <class Wd>
+struct ParallelTick {
+  static constexpr int STRIP_COUNT = (Wd::HEIGHT + STRIP_ROWS - 1) / STRIP_ROWS;
+  static constexpr int TILE_ROWS_PER_CHUNK = CHUNK_SIZE / Wd::TEMP_SCALE;
+
+  Wd *w;
+  uint8_t (*snapshot)[Wd::TEMP_W];  // previous diffusion pass
+  RandomBits rng;
+  int parity;  // strips with index % 2 == parity run in the current phase
+  int stepShift;  // the thermal step covers 1 << stepShift ticks
+  mutable std::atomic<int> active{0};  // cells updated, summed over strips
+};
+
+template <class Wd>
+static void diffuseRowTask(int cy, void *ctx) {
+  const ParallelTick<Wd> *tick = static_cast<ParallelTick<Wd> *>(ctx);
+  constexpr int N = Wd::TEMP_W / 4;
+  const TempWord *row = reinterpret_cast<const TempWord *>(tick->snapshot[cy]);
+  const TempWord *up  = cy > 0              ? reinterpret_cast<const TempWord *>(tick->snapshot[cy - 1]) : row;
+  const TempWord *dn  = cy < Wd::TEMP_H - 1 ? reinterpret_cast<const TempWord *>(tick->snapshot[cy + 1]) : row;
+  diffuseRowWords<N>(reinterpret_cast<TempWord *>(tick->w->temperature[cy]), up, row, dn, 0, N - 1);
+}
+
+// 'passes' blend passes over the whole field, a task per coarse row
+template <class Wd>
+static void diffuseParallel(ParallelTick<Wd>& tick, int passes) {
+  for (int pass = 0; pass < passes; pass++) {
+    memcpy(tick.snapshot, tick.w->temperature, sizeof(tick.w->temperature));
+    hostParallelFor(Wd::TEMP_H, diffuseRowTask<Wd>, &tick);
+  }
+}
+
+template <class Wd>
+static void injectChunkRowTask(int band, void *ctx) {
+  const ParallelTick<Wd> *tick = static_cast<ParallelTick<Wd> *>(ctx);
+  constexpr int ROWS = ParallelTick<Wd>::TILE_ROWS_PER_CHUNK;
+  RandomBits rng = tick->rng;
+  const int cy1 = (band + 1) * ROWS;
+  for (int cy = band * ROWS; cy < cy1 && cy < Wd::TEMP_UI_ROW; cy++)
+    for (int cx = 0; cx < Wd::TEMP_W; cx++)
+      injectTile(*tick->w, cx, cy, rng, tick->stepShift);
+}
+
+template <class Wd>
+static void stripTask(int i, void *ctx) {
+  const ParallelTick<Wd> *tick = static_cast<ParallelTick<Wd> *>(ctx);
+  RandomBits rng = tick->rng;
+  const int strip = 2 * i + tick->parity;
+  const int yTop = strip * STRIP_ROWS;
+  int y = yTop + STRIP_ROWS - 1;
+  if (y > Wd::HEIGHT - 2) y = Wd::HEIGHT - 2;
+  int active = 0;
+  for (; y >= yTop; y--)
+    active += scanRow(*tick->w, y, rng);
+  tick->active.fetch_add(active, std::memory_order_relaxed);
+}
+
+template <class Wd>
+static void simulateParallel(Wd& w) {
+  using Tick = ParallelTick<Wd>;
+  alignas(4) static uint8_t snapshot[Wd::TEMP_H][Wd::TEMP_W];
+  Tick tick = { &w, snapshot, randomBegin(), 0, 0 };
+  tick.rng.counter = true;
+
+  beginTick(w);
+
+  const bool profiling = profilerTiming();
+  uint32_t mark = profiling ? getMicros() : 0u;
+  const uint64_t tempStart = hostNanos();
+  // Same thermal schedule as temperatureTick().  The hierarchy's levels
+  // are small; they run on this thread.
+  diffuseParallel(tick, w.heatPasses);
+  if (w.heatLevels > 1) diffuseHeatLevels(w, nullptr);
+  if (w.thermalWait > 0) {
+    w.thermalWait--;
+    w.pinUiTemperature();
+    for (int cy = 0; cy < Wd::TEMP_UI_ROW; cy++)
+      for (int cx = 0; cx < Wd::TEMP_W; cx++)
+        w.thermalClassify(cx, cy, w.temperature[cy][cx]);
+    wakeThermalTiles(w);
+  } else {
+    tick.stepShift = __builtin_ctz(w.thermalStep);
+    hostParallelFor((Wd::TEMP_UI_ROW + Tick::TILE_ROWS_PER_CHUNK - 1) / Tick::TILE_ROWS_PER_CHUNK,
+                    injectChunkRowTask<Wd>, &tick);
+    w.pinUiTemperature();
+    w.thermalStep = thermalStepLength(w);
+    w.thermalWait = static_cast<uint8_t>(w.thermalStep - 1);
+  }
+  // The row tasks and concurrent injection do not track activity (the
+  // spans of neighbouring rows would be shared between tasks), so hand the
+  // next serial tick a fully marked field.
+  w.thermalMarkAll();
+  hostTempPassNanos += hostNanos() - tempStart;
+  if (profiling) profilerLap(ProfPhase::TEMPERATURE, mark);
+
+  for (int phase = 0; phase < 2; phase++) {
+    tick.parity = ((Tick::STRIP_COUNT - 1) + phase) & 1;
+    hostParallelFor((Tick::STRIP_COUNT - tick.parity + 1) / 2, stripTask<Wd>, &tick);
+  }
+  if (profiling) profilerLap(ProfPhase::PARTICLES, mark);
+  w.activeCells = tick.active.load(std::memory_order_relaxed);
+
+  randomEnd(tick.rng);
+  endTick(w);
+}
+#endif
+
+// One physics tick on world 'w'
+template <class Wd>
+static inline void simulateWorld(Wd& w) {
+  // The event counters are plain globals, so counter builds always take the
+  // serial path (the device's) to keep the counts exact.
+#if defined(HOST_BUILD) && !defined(PHYSICS_COUNTERS)
+  if (hostParallelThreads() > 1) {
+    simulateParallel(w);
+    return;
+  }
+#endif
+  // The tick's random bits come from a local pool (see random.h)
+  RandomBits rng = randomBegin();
+
+  beginTick(w);
+#ifdef PHYSICS_COUNTERS
+  physCountersBeginTick();
+#endif
+
+  // Split the tick for the profiler overlay and trace (read once so a toggle
+  // from input mid-tick cannot record half a split)
+  const bool profiling = profilerTiming();
+  uint32_t mark = profiling ? getMicros() : 0u;
+
+  // Propagate temperature (coarse grid, sub-cycled while the field is
+  // quiet).  Also wakes cells in tiles outside the thermally neutral band.
+#ifdef HOST_BUILD
+  const uint64_t tempStart = hostNanos();
+  temperatureTick(w, rng);
+  hostTempPassNanos += hostNanos() - tempStart;
+#else
+  temperatureTick(w, rng);
+#endif
+  if (profiling) profilerLap(ProfPhase::TEMPERATURE, mark);
+
+  // Update from bottom to top, randomizing left-right order.
+  // Only the dirty rectangle of each awake chunk is scanned.  The rectangle
+  // bounds are re-read on every step because updates can wake cells further
+  // along the current row (e.g. a plant growing sideways); cells woken behind
+  // the scan position are picked up on the next tick, exactly as a full scan
+  // would leave them.
+  int active = 0;
+  for (int y = Wd::HEIGHT - 2; y >= 0; y--)
+    active += scanRow(w, y, rng);
+  w.activeCells = active;
+  if (profiling) profilerLap(ProfPhase::PARTICLES, mark);
+
+  randomEnd(rng);
+  endTick(w);
+#ifdef PHYSICS_COUNTERS
+  physCountersEndTick();
+#endif
+}
+
+#endif // SIMULATION_H
@@ -0,0 +1,63 @@
+#include "trace.h"
+#include "physics.h"
+#include "renderer.h"
+#include "settings.h"
+
+bool traceRecording = false;
+bool traceFailed = false;
+
+static TraceBuffer trace;
+static uint16_t traceNext;   // ring slot of the next record
+
+void traceStart() {
+  traceFailed = false;
+  trace.header.recorded = 0;
+  traceNext = 0;
+  traceRecording = true;
+}
+
+static inline uint16_t saturate16(uint32_t v) {
+  return static_cast<uint16_t>(v > 0xFFFFu ? 0xFFFFu : v);
+}
+
+void traceRecord(uint32_t tick, bool rendered) {
+  TraceRecord& r = trace.records[traceNext];
+  r.tick = tick;
+  for (int p = 0; p < PROF_PHASE_COUNT; p++) r.phaseUs[p] = saturate16(profilerLastUs[p]);
+  if (!rendered) {
+    r.phaseUs[static_cast<int>(ProfPhase::DRAW)]    = 0;
+    r.phaseUs[static_cast<int>(ProfPhase::REFRESH)] = 0;
+  }
+  r.activeCells    = static_cast<uint16_t>(activeCellCount);
+  r.dirtyCells     = static_cast<uint16_t>(rendered ? drawnCellCount : 0);
+  r.awakeChunks    = static_cast<uint8_t>(awakeChunkCount);
+  r.overclockLevel = static_cast<uint8_t>(overclockLevel);
+  r.simSpeedMode   = static_cast<uint8_t>(simSpeedMode);
+  r.flags          = rendered ? TRACE_FLAG_RENDERED : 0;
+  r.reserved       = 0;
+
+  traceNext = static_cast<uint16_t>(traceNext + 1 == TRACE_CAPACITY ? 0 : traceNext + 1);
+  trace.header.recorded++;
+}
+
+size_t traceSerialize(const void** data) {
+  TraceHeader& h = trace.header;
+  const bool wrapped = h.recorded >= static_cast<uint32_t>(TRACE_CAPACITY);
+  h.magic      = TRACE_MAGIC;
+  h.version    = TRACE_VERSION;
+  h.recordSize = static_cast<uint16_t>(sizeof(TraceRecord));
+  h.count      = static_cast<uint16_t>(wrapped ? TRACE_CAPACITY : h.recorded);
+  h.first      = wrapped ? traceNext : 0;
+  h.phaseCount = static_cast<uint8_t>(PROF_PHASE_COUNT);
+  h.reserved[0] = h.reserved[1] = h.reserved[2] = 0;
+  *data = &trace;
+  return sizeof(TraceHeader) + h.count * sizeof(TraceRecord);
+}
+
+bool traceStop() {
+  traceRecording = false;
+  if (trace.header.recorded == 0) return false;
+  const void* data = nullptr;
+  const size_t size = traceSerialize(&data);
+  return saveTrace(data, static_cast<uint32_t>(size));
+}
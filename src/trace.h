@@ -0,0 +1,81 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+#include "config.h"
+#include "profiler.h"
+
+// Binary per-tick performance trace (3 key), for collecting real-device
+// timings and analysing them offline with fsand-tracedump.
+//
+// While recording, traceRecord() appends one fixed-size record per tick to a
+// ring holding the last TRACE_CAPACITY ticks.  A record is the native-endian
+// struct below, filled with plain stores; nothing is packed or converted
+// until traceFlush() writes header + ring to the FSandSim/PerfTrc MCS
+// variable in one go.  The decoder reads either byte order (the magic tells
+// which) and unrolls the ring starting at 'first'.
+
+constexpr int      TRACE_CAPACITY = 512;           // ~8.5 s at 60 ticks/s
+constexpr uint32_t TRACE_MAGIC    = 0x46535452u;   // "FSTR" when big-endian
+constexpr uint16_t TRACE_VERSION  = 1;
+
+// Record flags
+constexpr uint8_t TRACE_FLAG_RENDERED = 0x01;      // tick drew and refreshed
+
+struct TraceHeader {
+  uint32_t magic;        // TRACE_MAGIC, native byte order
+  uint16_t version;      // TRACE_VERSION
+  uint16_t recordSize;   // sizeof(TraceRecord)
+  uint32_t recorded;     // records written since traceStart() (may exceed count)
+  uint16_t count;        // records present (<= TRACE_CAPACITY)
+  uint16_t first;        // ring index of the oldest record
+  uint8_t  phaseCount;   // PROF_PHASE_COUNT
+  uint8_t  reserved[3];
+};
+
+struct TraceRecord {
+  uint32_t tick;                       // game-loop frame number
+  uint16_t phaseUs[PROF_PHASE_COUNT];  // ProfPhase order, saturated at 65535
+  uint16_t activeCells;                // cells updateCell() visited
+  uint16_t dirtyCells;                 // cells drawGrid() repainted (0 if not rendered)
+  uint8_t  awakeChunks;
+  uint8_t  overclockLevel;
+  uint8_t  simSpeedMode;
+  uint8_t  flags;                      // TRACE_FLAG_*
+  uint16_t reserved;                   // explicit tail padding (written as 0)
+};
+
+// The decoder relies on this exact layout (no implicit padding); adding a
+// phase means revisiting 'reserved'
+static_assert(sizeof(TraceHeader) == 20, "TraceHeader layout changed");
+static_assert(sizeof(TraceRecord) == 14 + 2 * PROF_PHASE_COUNT, "TraceRecord layout changed");
+static_assert(CHUNK_ROWS * CHUNK_COLS <= 255, "awakeChunks must fit a byte");
+static_assert(GRID_WIDTH * GRID_HEIGHT <= 65535, "cell counts must fit 16 bits");
+
+// Header followed by the ring, contiguous so the flush is a single write
+struct TraceBuffer {
+  TraceHeader header;
+  TraceRecord records[TRACE_CAPACITY];
+};
+
+// traceRecording (declared in profiler.h) is set between traceStart() and
+// traceStop(); traceFailed (also there) from a failed traceStop() until the
+// next traceStart().
+
+// Empty the ring and start recording (also turns phase timing on)
+void traceStart();
+
+// Append the tick that just finished.  'rendered' says whether this tick
+// drew a frame; DRAW / REFRESH hold stale samples otherwise and record as 0.
+void traceRecord(uint32_t tick, bool rendered);
+
+// Stop recording and write the trace to MCS.  Returns false if nothing was
+// recorded or the MCS write failed.
+bool traceStop();
+
+// Bytes of the trace as it would be flushed now, and a pointer to them
+// (header filled in); used by traceStop() and host tools.
+size_t traceSerialize(const void** data);
+
+#endif // TRACE_H
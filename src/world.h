@@ -0,0 +1,443 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "config.h"
+#include "particle.h"
+#include "counters.h"
+#include <cstring>
+
+// Sleep/wake chunk record.  Rectangles are inclusive and chunk-local
+// (0..CHUNK_SIZE-1); an empty rectangle (x0 > x1) means the chunk sleeps.
+//  cur  — cells simulate() scans this tick.  Grows while the tick runs so
+//         cells woken ahead of the scan position are still visited.
+//  next — cells woken during this tick; becomes 'cur' at the next tick.
+struct ChunkRect {
+  uint8_t x0, y0, x1, y1;
+};
+struct Chunk {
+  ChunkRect cur;
+  ChunkRect next;
+};
+constexpr ChunkRect CHUNK_RECT_EMPTY = { CHUNK_SIZE, CHUNK_SIZE, 0, 0 };
+constexpr ChunkRect CHUNK_RECT_FULL  = { 0, 0, CHUNK_SIZE - 1, CHUNK_SIZE - 1 };
+
+inline void chunkRectExtend(ChunkRect& r, int x0, int y0, int x1, int y1) {
+  if (x0 < r.x0) r.x0 = static_cast<uint8_t>(x0);
+  if (y0 < r.y0) r.y0 = static_cast<uint8_t>(y0);
+  if (x1 > r.x1) r.x1 = static_cast<uint8_t>(x1);
+  if (y1 > r.y1) r.y1 = static_cast<uint8_t>(y1);
+}
+
+// Occupancy: anything the update loop must visit, i.e. not AIR or WALL
+inline bool occupiesCell(Particle p) {
+  return particleProps[p].behavior > Behavior::STATIC;
+}
+
+// Column span of a coarse temperature row (see World::thermalSpans)
+struct TempSpan {
+  int16_t x0, x1;
+};
+
+// Per-coarse-tile material census: how many cells of each type the
+// temperature source pass cares about, as 5-bit counts packed into one word
+// at the CENSUS_* bit offsets.  CENSUS_UNIT[p] is a 1 in p's field (0 for
+// types nobody counts), so a cell changing from 'a' to 'b' is a single
+// census += CENSUS_UNIT[b] - CENSUS_UNIT[a]; the intermediate borrow
+// between fields cancels because no field ever goes negative.
+constexpr int CENSUS_FIELD_BITS = 5;
+constexpr int CENSUS_AIR   = 0 * CENSUS_FIELD_BITS;
+constexpr int CENSUS_WALL  = 1 * CENSUS_FIELD_BITS;
+constexpr int CENSUS_WATER = 2 * CENSUS_FIELD_BITS;
+constexpr int CENSUS_ICE   = 3 * CENSUS_FIELD_BITS;
+constexpr int CENSUS_FIRE  = 4 * CENSUS_FIELD_BITS;
+constexpr int CENSUS_LAVA  = 5 * CENSUS_FIELD_BITS;
+static_assert(CENSUS_LAVA + CENSUS_FIELD_BITS <= 32, "census fields must fit a word");
+
+struct CensusTable {
+  uint32_t rows[PARTICLE_TYPE_COUNT];
+  constexpr uint32_t operator[](Particle p) const {
+    return rows[static_cast<uint8_t>(p)];
+  }
+};
+
+constexpr CensusTable buildCensusTable() {
+  CensusTable table = {};
+  table.rows[static_cast<uint8_t>(Particle::AIR)]   = 1u << CENSUS_AIR;
+  table.rows[static_cast<uint8_t>(Particle::WALL)]  = 1u << CENSUS_WALL;
+  table.rows[static_cast<uint8_t>(Particle::WATER)] = 1u << CENSUS_WATER;
+  table.rows[static_cast<uint8_t>(Particle::ICE)]   = 1u << CENSUS_ICE;
+  table.rows[static_cast<uint8_t>(Particle::FIRE)]  = 1u << CENSUS_FIRE;
+  table.rows[static_cast<uint8_t>(Particle::LAVA)]  = 1u << CENSUS_LAVA;
+  return table;
+}
+constexpr CensusTable CENSUS_UNIT = buildCensusTable();
+
+// Count of one CENSUS_* field in a tile's census word
+constexpr int censusCount(uint32_t census, int field) {
+  return static_cast<int>((census >> field) & ((1u << CENSUS_FIELD_BITS) - 1u));
+}
+
+// ---------------------------------------------------------------------------
+// World<W, H, TempScale, UiBoundary>: one simulation world of W×H cells with
+// a coarse temperature tile per TempScale×TempScale block.  Rows at and
+// below UiBoundary sit behind the device's UI bar: they are never simulated
+// and their coarse tiles stay at TEMP_AMBIENT (UiBoundary == H means no UI).
+//
+// Everything simulate() touches — the row-pointer table, the updated / dirty
+// / occupied bitsets, the temperature field and its material census, and the
+// sleep/wake chunks — is a
+// member sized from the template arguments, and the kernels in simulation.h
+// are templated on the world type, so each instantiation constant-folds its
+// own dimensions exactly like the old global constexprs did.  The device
+// build has a single global World (see grid.h); host tools can instantiate
+// other sizes (e.g. a 1024×1024 benchmark world).
+//
+// Cell storage is not a member: the device splits its rows across on-chip
+// X/Y RAM and regular RAM, so the world only holds row pointers.  Each of
+// the H + 2 stored rows is STRIDE cells wide with a WALL sentinel at both
+// ends, plus a full WALL sentinel row above row 0 and below row H-1, so
+// at(x, y) is readable one step outside the grid without bounds checks.
+// Worlds that keep their cells in one block use Storage and attach().
+// ---------------------------------------------------------------------------
+template <int W, int H, int TempScale, int UiBoundary = H>
+struct World {
+  static constexpr int WIDTH       = W;
+  static constexpr int HEIGHT      = H;
+  static constexpr int TEMP_SCALE  = TempScale;
+  static constexpr int STRIDE      = W + 2;
+  static constexpr int WORDS       = (W + 31) / 32;
+  static constexpr int TEMP_W      = W / TempScale;
+  static constexpr int TEMP_H      = H / TempScale;
+  static constexpr int TEMP_WORDS  = (TEMP_W + 31) / 32;
+  static constexpr int CHUNK_COLS  = W / CHUNK_SIZE;
+  static constexpr int CHUNK_ROWS  = H / CHUNK_SIZE;
+  static constexpr int UI_BOUNDARY = UiBoundary;
+  // First coarse row lying entirely within the UI bar
+  static constexpr int TEMP_UI_ROW = UiBoundary / TempScale;
+
+  static_assert(W % CHUNK_SIZE == 0 && H % CHUNK_SIZE == 0,
+                "CHUNK_SIZE must divide the grid dimensions");
+  static_assert(CHUNK_SIZE % TempScale == 0, "chunks must cover whole coarse tiles");
+  static_assert(UiBoundary <= H && UiBoundary % TempScale == 0,
+                "the UI boundary must lie on a coarse row");
+  static_assert(TempScale * TempScale < (1 << CENSUS_FIELD_BITS),
+                "a tile's cell count must fit a census field");
+  static_assert(TEMP_W % 4 == 0, "diffusion packs four coarse tiles per word");
+  static_assert(H < static_cast<int>(RANDOM_TILE_DOMAIN) && W <= 0x10000,
+                "counter-mode keys of cells and coarse tiles must not overlap");
+  static_assert(TEMP_W % (1 << (TEMP_HEAT_LEVELS_MAX - 1)) == 0 &&
+                TEMP_H % (1 << (TEMP_HEAT_LEVELS_MAX - 1)) == 0,
+                "every heat level must cover whole tiles of the one above");
+
+  using Storage = Particle[H + 2][STRIDE];
+
+  // Row-pointer table covering the sentinel rows; each pointer addresses
+  // column 0 of its row (one past the left sentinel).
+  Particle *rows[H + 2];
+  alignas(32) uint32_t updated[H][WORDS];   // moved/changed this tick
+  // Dirty bitset: OR-accumulates updated flags across simulate() calls
+  // between renders; drawGrid() repaints set cells then clears it.
+  alignas(32) uint32_t dirty[H][WORDS];
+  // Movable-occupancy bitset: bit set for every cell holding a particle the
+  // update loop must visit, i.e. anything but AIR and WALL.  Maintained by
+  // swap(), setCell() and clear() so simulate() can jump between particles
+  // with count-trailing-zeros instead of testing every cell.
+  alignas(32) uint32_t occupied[H][WORDS];
+  alignas(32) uint8_t temperature[TEMP_H][TEMP_W];
+  // Material census per coarse tile (see CENSUS_UNIT).  Maintained by
+  // swap(), setCell() and clear() so the temperature source pass reads one
+  // word per tile instead of rescanning its TempScale² cells.
+  uint32_t census[TEMP_H][TEMP_W];
+  // Thermally active span of each coarse row (inclusive tile columns; empty
+  // when x0 > x1).  Tiles outside it sit at their diffusion fixed point:
+  // blending them with their current neighbours gives back their own value,
+  // so a diffusion pass may skip them.  Every write that changes a tile
+  // extends the spans over the tile and its four neighbours
+  // (thermalChanged()); a pass resets a row's span before sweeping it.  A
+  // uniform field (e.g. all ambient) has every span empty.
+  TempSpan thermalSpans[TEMP_H];
+  // Tiles outside the thermally neutral band, one bit each: their cells are
+  // kept awake on the ticks between thermal steps.  Set by the source pass
+  // and tempSet(), cleared with the UI rows by pinUiTemperature().
+  uint32_t thermalWake[TEMP_H][TEMP_WORDS];
+  // Phase changes due in each tile (a PHASE_DUE mask of its temperature).
+  // Set with the wake bits by the source pass and tempSet(); the source
+  // pass skips the rows behind the UI bar, which hold no particles.
+  uint8_t phaseDue[TEMP_H][TEMP_W];
+  // Thermal sub-cycling (see temperatureTick()): the next thermal step
+  // covers thermalStep ticks and runs after thermalWait more ticks.
+  uint8_t thermalStep;
+  uint8_t thermalWait;
+  // Diffusion schedule (see propagateTemperature()): blend passes over the
+  // field, then levels of the heat hierarchy (1 = the field alone).  Kept by
+  // clear(); the device sets it from the heat setting.
+  uint8_t heatPasses = TEMP_DIFFUSION_PASSES;
+  uint8_t heatLevels = 1;
+  // Longest thermal step, a power of 2 up to TEMP_SUBCYCLE_MAX (1 steps the
+  // field every tick; the fuzzer uses that to match the reference).  Kept by
+  // clear().
+  uint8_t heatStepMax = TEMP_SUBCYCLE_MAX;
+  Chunk chunks[CHUNK_ROWS][CHUNK_COLS];
+  int awakeChunks;  // chunks scanned by the most recent tick
+  int activeCells;  // cells updated by the most recent tick
+
+  // grid()[y][x] works like a 2-D array, sentinels included
+  Particle **grid() { return &rows[1]; }
+  Particle &at(int x, int y) { return rows[y + 1][x]; }
+
+  // Point the row table at a contiguous Storage block
+  void attach(Storage &cells) {
+    for (int y = 0; y < H + 2; y++) rows[y] = &cells[y][1];
+  }
+
+  // Reset to an empty world: WALL sentinels, AIR interior, a WALL row at
+  // UiBoundary - 1 (if there is a UI), ambient temperature, and every chunk
+  // awake so the next tick scans everything.  The row table must be set up.
+  void clear() {
+    for (int y = -1; y <= H; y++) {
+      Particle *row = rows[y + 1];
+      memset(row - 1, static_cast<int>(Particle::WALL), STRIDE);
+      if (y >= 0 && y < H) memset(row, static_cast<int>(Particle::AIR), W);
+    }
+    if (UiBoundary < H)
+      memset(rows[UiBoundary], static_cast<int>(Particle::WALL), W);
+    memset(updated, 0, sizeof(updated));
+    memset(dirty, 0xFF, sizeof(dirty)); // force full repaint after clear
+    memset(occupied, 0, sizeof(occupied)); // only AIR and WALL
+    memset(temperature, TEMP_AMBIENT, sizeof(temperature));
+    censusRebuild();
+    thermalMarkAll();
+    memset(thermalWake, 0, sizeof(thermalWake));  // ambient is neutral
+    memset(phaseDue, PHASE_DUE[TEMP_AMBIENT], sizeof(phaseDue));
+    thermalStep = 1;
+    thermalWait = 0;
+    for (int cy = 0; cy < CHUNK_ROWS; cy++)
+      for (int cx = 0; cx < CHUNK_COLS; cx++)
+        chunks[cy][cx] = { CHUNK_RECT_FULL, CHUNK_RECT_FULL };
+    awakeChunks = CHUNK_ROWS * CHUNK_COLS;
+    activeCells = 0;
+  }
+
+  // Pin the coarse rows behind the UI bar to TEMP_AMBIENT (a no-op without a
+  // UI).  Only tiles diffusion actually moved are rewritten, so their
+  // neighbours get re-examined by the next pass.
+  void pinUiTemperature() {
+    for (int cy = TEMP_UI_ROW; cy < TEMP_H; cy++) {
+      for (int i = 0; i < TEMP_WORDS; i++) thermalWake[cy][i] = 0;
+      for (int cx = 0; cx < TEMP_W; cx++) {
+        if (temperature[cy][cx] != TEMP_AMBIENT) {
+          temperature[cy][cx] = TEMP_AMBIENT;
+          thermalChanged(cx, cy);
+        }
+      }
+    }
+  }
+
+  // Thermal activity helpers (coarse-tile coordinates, see thermalSpans)
+  void thermalExtend(int cy, int x0, int x1) {
+    TempSpan &s = thermalSpans[cy];
+    if (x0 < s.x0) s.x0 = static_cast<int16_t>(x0 < 0 ? 0 : x0);
+    if (x1 > s.x1) s.x1 = static_cast<int16_t>(x1 > TEMP_W - 1 ? TEMP_W - 1 : x1);
+  }
+  // Tiles x0..x1 of row cy changed value: they and their neighbours need
+  // diffusing again
+  void thermalChangedRow(int cy, int x0, int x1) {
+    thermalExtend(cy, x0 - 1, x1 + 1);
+    if (cy > 0)          thermalExtend(cy - 1, x0, x1);
+    if (cy < TEMP_H - 1) thermalExtend(cy + 1, x0, x1);
+  }
+  void thermalChanged(int cx, int cy) { thermalChangedRow(cy, cx, cx); }
+  // Mark every tile (after bulk writes to the temperature field)
+  void thermalMarkAll() {
+    for (int cy = 0; cy < TEMP_H; cy++) thermalSpans[cy] = { 0, TEMP_W - 1 };
+  }
+  // Classify tile (cx, cy) at temperature 't': its phase changes due and
+  // whether it lies outside the neutral band (returned)
+  bool thermalClassify(int cx, int cy, uint8_t t) {
+    phaseDue[cy][cx] = PHASE_DUE[t];
+    const bool out = t < TEMP_NEUTRAL_MIN || t > TEMP_NEUTRAL_MAX;
+    const uint32_t bit = 1u << (cx & 31);
+    if (out) thermalWake[cy][cx >> 5] |= bit;
+    else     thermalWake[cy][cx >> 5] &= ~bit;
+    return out;
+  }
+
+  // Census word of the coarse tile holding fine cell (x, y)
+  uint32_t &censusAt(int x, int y) {
+    return census[y / TempScale][x / TempScale];
+  }
+
+  // Recount every tile from the cells (after bulk writes such as clear())
+  void censusRebuild() {
+    memset(census, 0, sizeof(census));
+    for (int y = 0; y < H; y++)
+      for (int x = 0; x < W; x++)
+        censusAt(x, y) += CENSUS_UNIT[at(x, y)];
+  }
+
+  // Coarse temperature accessors (fine-cell coordinates)
+  uint8_t tempGet(int x, int y) const {
+    return temperature[y / TempScale][x / TempScale];
+  }
+  uint8_t phaseDueAt(int x, int y) const {
+    return phaseDue[y / TempScale][x / TempScale];
+  }
+  void tempSet(int x, int y, uint8_t val) {
+    uint8_t &t = temperature[y / TempScale][x / TempScale];
+    if (t == val) return;
+    t = val;
+    const int cx = x / TempScale;
+    const int cy = y / TempScale;
+    thermalChanged(cx, cy);
+    thermalClassify(cx, cy, val);
+    // Cells of the tile the scan has not reached yet may change phase this
+    // very tick, asleep or not
+    if (phaseDue[cy][cx])
+      chunkWakeRect(cx * TempScale, cy * TempScale,
+                    cx * TempScale + TempScale - 1, cy * TempScale + TempScale - 1);
+  }
+
+  // Bitset helpers
+  bool updatedGet(int x, int y) const {
+    return (updated[y][x >> 5] >> (x & 31)) & 1u;
+  }
+  void updatedSet(int x, int y) {
+    updated[y][x >> 5] |= (1u << (x & 31));
+  }
+  void occupiedAssign(int x, int y, bool on) {
+    const uint32_t bit = 1u << (x & 31);
+    if (on) occupied[y][x >> 5] |= bit;
+    else    occupied[y][x >> 5] &= ~bit;
+  }
+  bool dirtyGet(int x, int y) const {
+    return (dirty[y][x >> 5] >> (x & 31)) & 1u;
+  }
+  void dirtySet(int x, int y) {
+    dirty[y][x >> 5] |= (1u << (x & 31));
+  }
+
+  // Wake every cell in [x0..x1]×[y0..y1] (fine-cell coordinates, clipped to
+  // the grid) for this tick and the next.  Handles rectangles spanning chunks.
+  void chunkWakeRect(int x0, int y0, int x1, int y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > W - 1) x1 = W - 1;
+    if (y1 > H - 1) y1 = H - 1;
+    if (x0 > x1 || y0 > y1) return;
+    for (int cy = y0 / CHUNK_SIZE; cy <= y1 / CHUNK_SIZE; cy++) {
+      const int base_y = cy * CHUNK_SIZE;
+      const int ly0 = (y0 > base_y) ? y0 - base_y : 0;
+      const int ly1 = (y1 < base_y + CHUNK_SIZE - 1) ? y1 - base_y : CHUNK_SIZE - 1;
+      for (int cx = x0 / CHUNK_SIZE; cx <= x1 / CHUNK_SIZE; cx++) {
+        const int base_x = cx * CHUNK_SIZE;
+        const int lx0 = (x0 > base_x) ? x0 - base_x : 0;
+        const int lx1 = (x1 < base_x + CHUNK_SIZE - 1) ? x1 - base_x : CHUNK_SIZE - 1;
+        Chunk &c = chunks[cy][cx];
+        chunkRectExtend(c.cur,  lx0, ly0, lx1, ly1);
+        chunkRectExtend(c.next, lx0, ly0, lx1, ly1);
+      }
+    }
+  }
+
+  // Keep a single cell awake: used when a particle did not change but may
+  // still do so on a later tick (skipped by shouldUpdate, pending reaction).
+  void chunkKeep(int x, int y) {
+    Chunk &c = chunks[y / CHUNK_SIZE][x / CHUNK_SIZE];
+    const int lx = x % CHUNK_SIZE;
+    const int ly = y % CHUNK_SIZE;
+    chunkRectExtend(c.cur,  lx, ly, lx, ly);
+    chunkRectExtend(c.next, lx, ly, lx, ly);
+  }
+
+  // A cell changed: wake it and its 8 neighbours, whose moves or reactions
+  // may have been unblocked.  Fast path when the 3×3 ring lies inside one
+  // chunk.
+  void chunkWake(int x, int y) {
+    const int lx = x % CHUNK_SIZE;
+    const int ly = y % CHUNK_SIZE;
+    if (lx > 0 && lx < CHUNK_SIZE - 1 && ly > 0 && ly < CHUNK_SIZE - 1) {
+      Chunk &c = chunks[y / CHUNK_SIZE][x / CHUNK_SIZE];
+      chunkRectExtend(c.cur,  lx - 1, ly - 1, lx + 1, ly + 1);
+      chunkRectExtend(c.next, lx - 1, ly - 1, lx + 1, ly + 1);
+      return;
+    }
+    chunkWakeRect(x - 1, y - 1, x + 1, y + 1);
+  }
+
+  // Start a tick: what was woken last tick is what gets scanned now
+  void chunksBeginTick() {
+    for (int cy = 0; cy < CHUNK_ROWS; cy++) {
+      for (int cx = 0; cx < CHUNK_COLS; cx++) {
+        Chunk &c = chunks[cy][cx];
+        c.cur  = c.next;
+        c.next = CHUNK_RECT_EMPTY;
+      }
+    }
+  }
+
+  // Number of chunks with a non-empty 'cur' rectangle
+  int chunksAwake() const {
+    int n = 0;
+    for (int cy = 0; cy < CHUNK_ROWS; cy++)
+      for (int cx = 0; cx < CHUNK_COLS; cx++)
+        if (chunks[cy][cx].cur.x0 <= chunks[cy][cx].cur.x1) n++;
+    return n;
+  }
+
+  // Write a cell, update its occupancy bit and tile census and wake its
+  // neighbourhood.  All particle type changes outside swap() go through here
+  // so the occupancy bitset and census stay exact and sleeping chunks notice
+  // them.
+  void setCell(int x, int y, Particle p) {
+    censusAt(x, y) += CENSUS_UNIT[p] - CENSUS_UNIT[at(x, y)];
+    at(x, y) = p;
+    occupiedAssign(x, y, occupiesCell(p));
+    chunkWake(x, y);
+  }
+
+  // Check if coordinates are inside the grid
+  static bool isValid(int x, int y) {
+    return x >= 0 && x < W && y >= 0 && y < H;
+  }
+
+  // Check if a cell is inside the grid and empty (air)
+  bool isEmpty(int x, int y) {
+    return isValid(x, y) && at(x, y) == Particle::AIR;
+  }
+
+  // Check if a particle of 'type' can move to a position: the occupant is
+  // displaceable by 'type' (see PARTICLE_DISPLACES).  No bounds check —
+  // valid for any neighbour of an in-grid cell, since the sentinel ring and
+  // the wall at UiBoundary - 1 read as WALL, which nothing displaces.  The
+  // constant 'type' every kernel passes folds to an immediate.
+  bool canMoveTo(int x, int y, Particle type) {
+    physCount(PhysCounter::PROBES);
+    return (PARTICLE_DISPLACES[type] >> static_cast<uint8_t>(at(x, y))) & 1u;
+  }
+
+  // Swap two particles
+  void swap(int x1, int y1, int x2, int y2) {
+    physCount(PhysCounter::MOVES);
+    Particle temp = at(x1, y1);
+    at(x1, y1) = at(x2, y2);
+    at(x2, y2) = temp;
+    // Only a swap across a coarse tile boundary changes the census: tile 1
+    // trades its old particle for tile 2's and vice versa
+    if (x1 / TempScale != x2 / TempScale || y1 / TempScale != y2 / TempScale) {
+      const uint32_t delta = CENSUS_UNIT[at(x1, y1)] - CENSUS_UNIT[temp];
+      censusAt(x1, y1) += delta;
+      censusAt(x2, y2) -= delta;
+    }
+    // Exchange occupancy bits: toggling both is only needed when they differ
+    const uint32_t b1 = (occupied[y1][x1 >> 5] >> (x1 & 31)) & 1u;
+    const uint32_t b2 = (occupied[y2][x2 >> 5] >> (x2 & 31)) & 1u;
+    if (b1 != b2) {
+      occupied[y1][x1 >> 5] ^= 1u << (x1 & 31);
+      occupied[y2][x2 >> 5] ^= 1u << (x2 & 31);
+    }
+    chunkWake(x1, y1);
+    chunkWake(x2, y2);
+  }
+};
+
+#endif // WORLD_H